@@ -0,0 +1,80 @@
+#include "DD_AABBTreeBroadphase.h"
+#include <algorithm>
+
+DD_AABBTreeBroadphase::DD_AABBTreeBroadphase(float fatMargin)
+    : m_tree(fatMargin)
+    , m_reinsertCount(0)
+{
+}
+
+DD_AABBTreeBroadphase::~DD_AABBTreeBroadphase()
+{
+}
+
+int DD_AABBTreeBroadphase::CreateProxy(const AABB& bounds, void* userData, const CollisionFilter& filter)
+{
+    int proxyId = m_tree.CreateProxy(bounds, userData);
+    if (proxyId >= static_cast<int>(m_tightBounds.size()))
+    {
+        m_tightBounds.resize(proxyId + 1);
+    }
+    m_tightBounds[proxyId] = TreeBounds::FromAABB(bounds);
+    SetFilter(proxyId, filter);
+    return proxyId;
+}
+
+void DD_AABBTreeBroadphase::DestroyProxy(int proxyId)
+{
+    m_tree.DestroyProxy(proxyId);
+}
+
+void DD_AABBTreeBroadphase::MoveProxy(int proxyId, const AABB& bounds)
+{
+    TreeBounds tight = TreeBounds::FromAABB(bounds);
+    Vec3 displacement = tight.lower - m_tightBounds[proxyId].lower;
+    m_tightBounds[proxyId] = tight;
+
+    if (m_tree.MoveProxy(proxyId, bounds, displacement)) ++m_reinsertCount;
+}
+
+void DD_AABBTreeBroadphase::ComputePairs(std::vector<BroadphasePair>& outPairs)
+{
+    outPairs.clear();
+    m_tree.QueryPairs([this, &outPairs](int a, int b)
+    {
+        // Fat AABBs overlap; only report compatible pairs whose exact bounds overlap
+        if (!PassesFilter(a, b)) return;
+        if (!m_tightBounds[a].Overlaps(m_tightBounds[b])) return;
+        if (a > b) std::swap(a, b);
+        outPairs.push_back({ a, b });
+    });
+    std::sort(outPairs.begin(), outPairs.end());
+    m_reinsertCount = 0;
+}
+
+void DD_AABBTreeBroadphase::Query(const AABB& bounds, std::vector<int>& outProxies) const
+{
+    TreeBounds query = TreeBounds::FromAABB(bounds);
+    m_tree.Query(query, [this, &query, &outProxies](int proxyId)
+    {
+        if (m_tightBounds[proxyId].Overlaps(query)) outProxies.push_back(proxyId);
+        return true;
+    });
+}
+
+void DD_AABBTreeBroadphase::QueryRay(const Vec3& origin, const Vec3& dir, float maxT, std::vector<int>& outProxies) const
+{
+    m_tree.RayCast(origin, dir, maxT, [&outProxies](int proxyId, float clip)
+    {
+        outProxies.push_back(proxyId);
+        return clip;
+    });
+}
+
+void DD_AABBTreeBroadphase::QueryRayPacket(const RayPacket& packet, std::vector<int>& outProxies) const
+{
+    m_tree.RayCastPacket(packet, [&outProxies](int proxyId, int /*laneMask*/)
+    {
+        outProxies.push_back(proxyId);
+    });
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "DD_Broadphase.h"
+#include "DD_DynamicAABBTree.h"
+
+// Broadphase backed by a dynamic AABB tree.
+// Proxies are refit only when they leave their fat AABB, and candidate pairs come from a
+// tree-vs-tree traversal. The tree is also exposed for scene queries (raycasts, overlap tests).
+class DD_AABBTreeBroadphase : public DD_Broadphase
+{
+public:
+    explicit DD_AABBTreeBroadphase(float fatMargin = 0.1f);
+    virtual ~DD_AABBTreeBroadphase();
+
+    virtual BroadphaseType GetType() const override { return BroadphaseType::AABBTree; }
+
+    virtual int CreateProxy(const AABB& bounds, void* userData, const CollisionFilter& filter) override;
+    virtual void DestroyProxy(int proxyId) override;
+    virtual void MoveProxy(int proxyId, const AABB& bounds) override;
+    virtual void ComputePairs(std::vector<BroadphasePair>& outPairs) override;
+    virtual void Query(const AABB& bounds, std::vector<int>& outProxies) const override;
+    virtual void QueryRay(const Vec3& origin, const Vec3& dir, float maxT, std::vector<int>& outProxies) const override;
+    virtual void QueryRayPacket(const RayPacket& packet, std::vector<int>& outProxies) const override;
+
+    virtual void* GetUserData(int proxyId) const override { return m_tree.GetUserData(proxyId); }
+    virtual int GetProxyCount() const override { return m_tree.GetProxyCount(); }
+
+    const DD_DynamicAABBTree& GetTree() const { return m_tree; }
+
+    // Exact (non-fat) bounds last given for a proxy
+    const TreeBounds& GetTightBounds(int proxyId) const { return m_tightBounds[proxyId]; }
+
+    int GetReinsertCount() const { return m_reinsertCount; }
+
+private:
+    DD_DynamicAABBTree m_tree;
+    std::vector<TreeBounds> m_tightBounds;  // Indexed by proxy id
+    int m_reinsertCount;                    // Leaves reinserted since the last ComputePairs
+};
@@ -2,11 +2,18 @@
 #include "DD_Component.h"
 #include "DD_MeshComponent.h"
 #include "DD_CollisionComponent.h"
+#include "DD_RigidBodyComponent.h"
+#include "DD_TransformHierarchy.h"
+#include <algorithm>
+#include <cstdio>
+
+constexpr uint32_t DD_Actor::InvalidEntity;
 
 DD_Actor::DD_Actor()
     : meshComp(nullptr)
     , collisionComp(nullptr)
     , m_active(true)
+    , m_collisionDirty(true)
 {
 }
 
@@ -18,6 +25,8 @@ DD_Actor::~DD_Actor()
         if (comp) comp->OnDetach();
     }
     m_components.clear();
+
+    if (m_transforms) m_transforms->Free(m_transformIndex);
 }
 
 void DD_Actor::AddComponent(DD_Component* component)
@@ -32,18 +41,51 @@ void DD_Actor::AddComponent(DD_Component* component)
 
     m_components.push_back(component);
     component->OnAttach(this);
+
+    ComponentType type = component->GetType();
+    if (type != ComponentType::None && !m_componentSlots[static_cast<int>(type)])
+    {
+        m_componentSlots[static_cast<int>(type)] = component;
+    }
 }
 
 void DD_Actor::RemoveComponent(DD_Component* component)
 {
     if (!component) return;
 
+    if (component == m_rigidBody) m_rigidBody = nullptr;
+
     auto it = std::find(m_components.begin(), m_components.end(), component);
-    if (it != m_components.end())
+    if (it == m_components.end()) return;
+
+    (*it)->OnDetach();
+    m_components.erase(it);
+
+    // Hand the slot to the next component of the same type, if any
+    const int slot = static_cast<int>(component->GetType());
+    if (m_componentSlots[slot] != component) return;
+    m_componentSlots[slot] = nullptr;
+    for (auto* comp : m_components)
+    {
+        if (comp->GetType() == component->GetType())
+        {
+            m_componentSlots[slot] = comp;
+            break;
+        }
+    }
+}
+
+void DD_Actor::RelocateComponent(DD_Component* from, DD_Component* to)
+{
+    for (auto*& comp : m_components)
     {
-        (*it)->OnDetach();
-        m_components.erase(it);
+        if (comp == from) comp = to;
     }
+    for (auto*& slot : m_componentSlots)
+    {
+        if (slot == from) slot = to;
+    }
+    if (m_rigidBody == from) m_rigidBody = static_cast<DD_RigidBodyComponent*>(to);
 }
 
 void DD_Actor::SetMeshComponent(DD_MeshComponent* mesh)
@@ -56,9 +98,43 @@ void DD_Actor::SetCollisionComponent(DD_CollisionComponent* coll)
     collisionComp = coll;
 }
 
-Matrix4 DD_Actor::GetModelMatrix() const
+void DD_Actor::SetRigidBodyComponent(DD_RigidBodyComponent* body)
+{
+    if (m_rigidBody) RemoveComponent(m_rigidBody);
+    m_rigidBody = body;
+    if (body) AddComponent(body);
+}
+
+void DD_Actor::OnTransformChanged()
+{
+    m_collisionDirty = true;
+    if (m_transforms) m_transforms->MarkDirty(m_transformIndex);
+    if (m_hierarchy) m_hierarchy->MarkDirty(m_hierarchyNode);
+}
+
+const Matrix4& DD_Actor::GetModelMatrix() const
 {
-    return BuildModelMatrix(m_transform);
+    if (m_hierarchy) return m_hierarchy->GetWorldMatrix(m_hierarchyNode);
+    return GetLocalMatrix();
+}
+
+const Matrix4& DD_Actor::GetLocalMatrix() const
+{
+    if (m_transforms) return m_transforms->GetLocalMatrix(m_transformIndex);
+    m_standaloneMatrix = BuildModelMatrix(m_standalone);
+    return m_standaloneMatrix;
+}
+
+bool DD_Actor::SetParent(DD_Actor* parent)
+{
+    if (!m_hierarchy) return false;
+    if (parent && parent->m_hierarchy != m_hierarchy) return false;
+    if (parent && (collisionComp || m_rigidBody))
+    {
+        printf("Warning: %s has a collider or rigid body and cannot be parented\n", m_name.c_str());
+        return false;
+    }
+    return m_hierarchy->SetParent(m_hierarchyNode, parent ? parent->m_hierarchyNode : -1);
 }
 
 void DD_Actor::Update(float deltaTime)
@@ -1,13 +1,18 @@
 #pragma once
 #include "DD_GLHelper.h"
+#include "DD_Component.h"
 #include "DD_Transform.h"
+#include "DD_TransformStorage.h"
 #include <memory>
 #include <vector>
 #include <string>
+#include <type_traits>
 
 class DD_Component;
 class DD_MeshComponent;
 class DD_CollisionComponent;
+class DD_RigidBodyComponent;
+class DD_TransformHierarchy;
 
 class DD_Actor
 {
@@ -15,13 +20,31 @@ public:
     DD_Actor();
     virtual ~DD_Actor();
 
-    // Component system
+    // Inside a world the actor owns a slot in the world's DD_TransformStorage
+    DD_Actor(const DD_Actor&) = delete;
+    DD_Actor& operator=(const DD_Actor&) = delete;
+
+    // Component system. The first component of each ComponentType also fills that
+    // type's slot, so typed lookups are a single array read.
     void AddComponent(DD_Component* component);
     void RemoveComponent(DD_Component* component);
-    
+
+    // Points every reference to from at to; used by pools that move components
+    void RelocateComponent(DD_Component* from, DD_Component* to);
+
+    DD_Component* GetComponent(ComponentType type) const { return m_componentSlots[static_cast<int>(type)]; }
+
     template<typename T>
     T* GetComponent() const
     {
+        // The slot may hold any class of that type, so only the class that declared the
+        // type can be cast to without a check
+        if (T::StaticType != ComponentType::None && std::is_same<T, typename T::SlotClass>::value)
+        {
+            return static_cast<T*>(m_componentSlots[static_cast<int>(T::StaticType)]);
+        }
+
+        // Components without a type of their own, and subclasses of typed ones, need the scan
         for (auto* comp : m_components)
         {
             T* result = dynamic_cast<T*>(comp);
@@ -39,33 +62,67 @@ public:
     void SetCollisionComponent(DD_CollisionComponent* coll);
     DD_CollisionComponent* GetCollisionComponent() const { return collisionComp; }
 
-    // Transform API
-    void SetPosition(const Vec3& pos) { m_transform.position = pos; OnTransformChanged(); }
-    Vec3 GetPosition() const { return m_transform.position; }
-
-    void SetRotationQuat(const Quaternion& q) { SetQuat(m_transform, q); OnTransformChanged(); }
-    Quaternion GetRotationQuat() const { return GetQuat(m_transform); }
-
-    void SetRotationEuler(const Vec3& eulerRad) { m_transform.rotation = eulerRad; OnTransformChanged(); }
-    Vec3 GetRotationEuler() const { return m_transform.rotation; }
-
-    void SetScale(const Vec3& s) { m_transform.scale = s; OnTransformChanged(); }
-    Vec3 GetScale() const { return m_transform.scale; }
-
-    // Position/rotation helpers
-    void AddPosition(const Vec3& delta) { Translate(m_transform, delta); OnTransformChanged(); }
-    void AddRotationEuler(const Vec3& eulerDelta) { Rotate(m_transform, eulerDelta); OnTransformChanged(); }
-    void AddRotationAxis(float angleRadians, const Vec3& axis) { RotateAxis(m_transform, angleRadians, axis); OnTransformChanged(); }
-
-    // Transform access
-    const Transform& GetTransform() const { return m_transform; }
-    Transform& GetTransform() { return m_transform; }
-
-    // Virtual methods for derived actors
+    // Also attaches the body through AddComponent
+    void SetRigidBodyComponent(DD_RigidBodyComponent* body);
+    DD_RigidBodyComponent* GetRigidBodyComponent() const { return m_rigidBody; }
+
+    // Transform API, backed by the world's DD_TransformStorage once the actor is added to
+    // a world, and by a plain Transform before that
+    void SetPosition(const Vec3& pos) { if (m_transforms) m_transforms->SetPosition(m_transformIndex, pos); else m_standalone.position = pos; OnTransformChanged(); }
+    Vec3 GetPosition() const { return m_transforms ? m_transforms->GetPosition(m_transformIndex) : m_standalone.position; }
+
+    void SetRotationQuat(const Quaternion& q) { if (m_transforms) m_transforms->SetRotation(m_transformIndex, glm::normalize(q)); else m_standalone.rotation = glm::normalize(q); OnTransformChanged(); }
+    Quaternion GetRotationQuat() const { return m_transforms ? m_transforms->GetRotation(m_transformIndex) : m_standalone.rotation; }
+
+    void SetRotationEuler(const Vec3& eulerRad) { SetRotationQuat(QuatFromEuler(eulerRad)); }
+    Vec3 GetRotationEuler() const { return EulerFromQuat(GetRotationQuat()); }
+
+    void SetScale(const Vec3& s) { if (m_transforms) m_transforms->SetScale(m_transformIndex, s); else m_standalone.scale = s; OnTransformChanged(); }
+    Vec3 GetScale() const { return m_transforms ? m_transforms->GetScale(m_transformIndex) : m_standalone.scale; }
+
+    // Position/rotation helpers, same composition order as Translate/Rotate/RotateAxis
+    void AddPosition(const Vec3& delta) { SetPosition(GetPosition() + delta); }
+    void AddRotationEuler(const Vec3& eulerDelta) { SetRotationQuat(QuatFromEuler(eulerDelta) * GetRotationQuat()); }
+    void AddRotationAxis(float angleRadians, const Vec3& axis) { SetRotationQuat(glm::angleAxis(angleRadians, glm::normalize(axis)) * GetRotationQuat()); }
+
+    // Whole-transform copies, gathered from and scattered to the SoA arrays
+    Transform GetTransform() const { return m_transforms ? m_transforms->GetTransform(m_transformIndex) : m_standalone; }
+    void SetTransform(const Transform& t) { if (m_transforms) m_transforms->SetTransform(m_transformIndex, t); else m_standalone = t; OnTransformChanged(); }
+    // Slot in the world's storage; -1 and nullptr outside a world
+    int GetTransformIndex() const { return m_transformIndex; }
+    DD_TransformStorage* GetTransformStorage() const { return m_transforms; }
+
+    // Virtual methods for derived actors.
+    // Update runs in parallel with other actors' updates: it may change this actor and its
+    // components, read shared data that nothing writes during the update, and spawn or
+    // destroy through DD_World::GetCommandBuffer. Anything else, GL calls included,
+    // belongs in MainThreadUpdate, which runs afterwards on the main thread in actor order.
     virtual void Update(float deltaTime);
+    virtual void MainThreadUpdate(float deltaTime) {}
     virtual void Render(const Matrix4& view, const Matrix4& projection);
     
-    Matrix4 GetModelMatrix() const;
+    // World matrix. Inside a world it is the hierarchy's matrix, valid after the world's
+    // transform update; a standalone actor returns its local matrix.
+    const Matrix4& GetModelMatrix() const;
+    Vec3 GetWorldPosition() const { return Vec3(GetModelMatrix()[3]); }
+
+    // Matrix of the transform relative to the parent, rebuilt on first use after a change
+    // or by DD_TransformStorage::UpdateLocalMatrices. The world composes every dirty matrix
+    // before the parallel Update; during it, read another actor's matrix only if that
+    // actor does not change in the update.
+    const Matrix4& GetLocalMatrix() const;
+
+    // Both actors must belong to the same world. The transform becomes relative to the
+    // parent. Returns false for a cycle or actors outside a world; nullptr detaches.
+    // Physics works on the local transform, so actors with a collision or rigid body
+    // component cannot be parented (also returns false).
+    bool SetParent(DD_Actor* parent);
+    DD_Actor* GetParent() const { return m_parent; }
+    int GetHierarchyNode() const { return m_hierarchyNode; }
+
+    // Key into the world's component pools, InvalidEntity outside a world
+    static constexpr uint32_t InvalidEntity = 0xFFFFFFFFu;
+    uint32_t GetEntityId() const { return m_entityId; }
 
     // Actor lifecycle
     void SetActive(bool active) { m_active = active; }
@@ -74,8 +131,13 @@ public:
     void SetName(const std::string& name) { m_name = name; }
     const std::string& GetName() const { return m_name; }
 
+    // Set by OnTransformChanged, cleared by the world once the broadphase proxy is updated
+    bool IsCollisionDirty() const { return m_collisionDirty; }
+    void ClearCollisionDirty() { m_collisionDirty = false; }
+
 protected:
-    virtual void OnTransformChanged() {}
+    // Overrides must call DD_Actor::OnTransformChanged()
+    virtual void OnTransformChanged();
 
 protected:
     // Legacy component pointers (for backward compatibility)
@@ -85,8 +147,29 @@ protected:
     // Component list (non-owning)
     std::vector<DD_Component*> m_components;
 
+    // Per ComponentType, the first attached component of that type (ComponentType::None stays empty)
+    DD_Component* m_componentSlots[kComponentTypeCount] = {};
+
+    // Cached so the physics loop does not search m_components
+    DD_RigidBodyComponent* m_rigidBody = nullptr;
+
 private:
-    Transform m_transform;
+    friend class DD_World;
+    uint32_t m_entityId = InvalidEntity;
+
+    // Slot in the world's DD_TransformStorage, updated by the storage when slots move
+    friend class DD_TransformStorage;
+    DD_TransformStorage* m_transforms = nullptr;
+    int m_transformIndex = -1;
+    Transform m_standalone;                  // Until a world binds the actor
+    mutable Matrix4 m_standaloneMatrix;
     bool m_active;
+    bool m_collisionDirty;
     std::string m_name;
+
+    // Hierarchy node, maintained by DD_TransformHierarchy
+    friend class DD_TransformHierarchy;
+    DD_TransformHierarchy* m_hierarchy = nullptr;
+    int m_hierarchyNode = -1;
+    DD_Actor* m_parent = nullptr;
 };
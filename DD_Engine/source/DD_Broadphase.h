@@ -0,0 +1,119 @@
+#pragma once
+#include "DD_CollisionUtils.h"
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+// Candidate pair reported by a broadphase. proxyA < proxyB always.
+struct BroadphasePair
+{
+    int proxyA;
+    int proxyB;
+};
+
+inline bool operator<(const BroadphasePair& a, const BroadphasePair& b)
+{
+    return a.proxyA < b.proxyA || (a.proxyA == b.proxyA && a.proxyB < b.proxyB);
+}
+
+enum class BroadphaseType
+{
+    BruteForce = 0,  // Legacy all-pairs loop, kept for comparison
+    SweepAndPrune,
+    SpatialHash,
+    AABBTree
+};
+
+// Per-tick collision counters, filled by DD_World::ProcessCollisions
+struct CollisionStats
+{
+    uint32_t proxyCount = 0;
+    uint32_t proxiesMoved = 0;
+    uint32_t candidatePairs = 0;    // Pairs handed to the narrowphase
+    uint32_t filteredPairs = 0;     // Pairs dropped by layer/mask or body type before any bounds test
+    uint32_t narrowphaseTests = 0;  // Shape tests actually run
+    uint32_t batchedTests = 0;      // Of those, AABB pairs run through the SIMD batch kernel
+    uint32_t contacts = 0;
+    uint32_t islands = 0;           // Independent contact groups resolved in parallel
+    uint32_t largestIsland = 0;     // Contacts in the biggest island
+    uint32_t awakeBodies = 0;       // Rigid bodies simulated this tick
+    uint32_t sleepingBodies = 0;
+    uint32_t warmStarted = 0;       // Body contacts seeded with last tick's impulse
+    uint32_t ccdSweeps = 0;         // Bodies fast enough to be swept this tick
+    uint32_t ccdHits = 0;           // Of those, bodies stopped at their time of impact
+    uint32_t layerPairs[32] = {};   // Candidate pairs per layer bit, counted once for each layer of either side
+    float broadphaseMs = 0.0f;
+    float narrowphaseMs = 0.0f;
+};
+
+// Interface for broadphase structures that keep proxies between frames
+class DD_Broadphase
+{
+public:
+    virtual ~DD_Broadphase() {}
+
+    virtual BroadphaseType GetType() const = 0;
+
+    // Returns a proxy id (>= 0). userData is handed back through GetUserData.
+    // Pairs whose filters do not match are never reported.
+    virtual int CreateProxy(const AABB& bounds, void* userData, const CollisionFilter& filter) = 0;
+    virtual void DestroyProxy(int proxyId) = 0;
+    virtual void MoveProxy(int proxyId, const AABB& bounds) = 0;
+
+    // Fill outPairs with every proxy pair whose bounds overlap, sorted by (proxyA, proxyB)
+    virtual void ComputePairs(std::vector<BroadphasePair>& outPairs) = 0;
+
+    // Append every proxy whose bounds overlap the query box to outProxies
+    virtual void Query(const AABB& bounds, std::vector<int>& outProxies) const = 0;
+
+    // Append proxies whose bounds the segment origin + dir * t, t in [0, maxT], may touch.
+    // May report false positives; the default queries the box around the segment.
+    virtual void QueryRay(const Vec3& origin, const Vec3& dir, float maxT, std::vector<int>& outProxies) const
+    {
+        RayPacket packet;
+        packet.Add(origin, dir, maxT);
+        Query(packet.GetBounds(), outProxies);
+    }
+
+    // Same for every ray of a packet at once (each proxy appended once)
+    virtual void QueryRayPacket(const RayPacket& packet, std::vector<int>& outProxies) const
+    {
+        Query(packet.GetBounds(), outProxies);
+    }
+
+    virtual void* GetUserData(int proxyId) const = 0;
+    virtual int GetProxyCount() const = 0;
+
+    const CollisionFilter& GetFilter(int proxyId) const { return m_filters[proxyId]; }
+
+    // Pairs rejected by the filter since the last reset. Sweep-and-prune rejects pairs
+    // while proxies move, the other structures inside ComputePairs.
+    uint32_t GetFilteredPairCount() const { return m_filteredPairs; }
+    void ResetFilteredPairCount() { m_filteredPairs = 0; }
+
+protected:
+    void SetFilter(int proxyId, const CollisionFilter& filter)
+    {
+        if (proxyId >= static_cast<int>(m_filters.size())) m_filters.resize(proxyId + 1);
+        m_filters[proxyId] = filter;
+    }
+
+    // Implementations call this before looking at the bounds of a pair
+    bool PassesFilter(int a, int b)
+    {
+        if (ShouldCollide(m_filters[a], m_filters[b])) return true;
+        ++m_filteredPairs;
+        return false;
+    }
+
+    std::vector<CollisionFilter> m_filters;  // Indexed by proxy id
+    uint32_t m_filteredPairs = 0;
+};
+
+// Strict overlap, matching CollisionUtils::TestAABBvsAABB (touching boxes do not collide)
+inline bool AABBOverlap(const AABB& a, const AABB& b)
+{
+    return fabsf(a.center.x - b.center.x) < a.halfExtents.x + b.halfExtents.x
+        && fabsf(a.center.y - b.center.y) < a.halfExtents.y + b.halfExtents.y
+        && fabsf(a.center.z - b.center.z) < a.halfExtents.z + b.halfExtents.z;
+}
@@ -12,10 +12,10 @@ public:
     Vec3 GetPosition() const { return m_transform.position; }
 
     void SetRotationQuat(const Quaternion& q) { SetQuat(m_transform, q); }
-    Quaternion GetRotationQuat() const { return GetQuat(m_transform); }
+    const Quaternion& GetRotationQuat() const { return m_transform.rotation; }
 
-    void SetRotationEuler(const Vec3& euler) { m_transform.rotation = euler; }
-    Vec3 GetRotationEuler() const { return m_transform.rotation; }
+    void SetRotationEuler(const Vec3& euler) { SetEuler(m_transform, euler); }
+    Vec3 GetRotationEuler() const { return GetEuler(m_transform); }
 
     void SetScale(const Vec3& s) { m_transform.scale = s; }
     Vec3 GetScale() const { return m_transform.scale; }
@@ -25,10 +25,15 @@ public:
 
     const Matrix4& GetViewMatrix() const { return m_view; }
     const Matrix4& GetProjectionMatrix() const { return m_projection; }
+    Matrix4 GetViewProjectionMatrix() const { return m_projection * m_view; }
+    float GetNearPlane() const { return m_near; }
+    float GetFarPlane() const { return m_far; }
 
 private:
     Transform m_transform;
     Matrix4 m_view;
     Matrix4 m_projection;
     float m_fov;
+    float m_near;
+    float m_far;
 };
\ No newline at end of file
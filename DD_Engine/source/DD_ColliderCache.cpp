@@ -0,0 +1,58 @@
+#include "DD_ColliderCache.h"
+
+DD_ColliderCache::DD_ColliderCache()
+{
+}
+
+DD_ColliderCache::~DD_ColliderCache()
+{
+}
+
+void DD_ColliderCache::Grow(int slot)
+{
+    size_t size = static_cast<size_t>(slot) + 1;
+    if (size <= m_colliders.size()) return;
+
+    m_centerX.resize(size, 0.0f);
+    m_centerY.resize(size, 0.0f);
+    m_centerZ.resize(size, 0.0f);
+    m_halfX.resize(size, 0.0f);
+    m_halfY.resize(size, 0.0f);
+    m_halfZ.resize(size, 0.0f);
+    m_colliders.resize(size);
+    m_actors.resize(size, nullptr);
+}
+
+void DD_ColliderCache::Set(int slot, const WorldCollider& collider, DD_Actor* actor)
+{
+    Grow(slot);
+
+    AABB bounds = CollisionUtils::ComputeBounds(collider);
+    m_centerX[slot] = bounds.center.x;
+    m_centerY[slot] = bounds.center.y;
+    m_centerZ[slot] = bounds.center.z;
+    m_halfX[slot] = bounds.halfExtents.x;
+    m_halfY[slot] = bounds.halfExtents.y;
+    m_halfZ[slot] = bounds.halfExtents.z;
+    m_colliders[slot] = collider;
+    m_actors[slot] = actor;
+}
+
+void DD_ColliderCache::Remove(int slot)
+{
+    if (slot < 0 || slot >= static_cast<int>(m_colliders.size())) return;
+    m_colliders[slot].type = CollisionShapeType::None;
+    m_actors[slot] = nullptr;
+}
+
+void DD_ColliderCache::Clear()
+{
+    m_centerX.clear();
+    m_centerY.clear();
+    m_centerZ.clear();
+    m_halfX.clear();
+    m_halfY.clear();
+    m_halfZ.clear();
+    m_colliders.clear();
+    m_actors.clear();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "DD_CollisionUtils.h"
+#include <vector>
+
+class DD_Actor;
+
+// Structure-of-arrays snapshot of world colliders, indexed by broadphase proxy id.
+// The narrowphase reads bounds from here instead of chasing actor pointers, and
+// gathers AABB candidates into batches for CollisionUtils::TestAABBvsAABBBatch.
+class DD_ColliderCache
+{
+public:
+    DD_ColliderCache();
+    ~DD_ColliderCache();
+
+    void Set(int slot, const WorldCollider& collider, DD_Actor* actor);
+    void Remove(int slot);
+    void Clear();
+
+    bool IsValid(int slot) const { return slot >= 0 && slot < static_cast<int>(m_colliders.size()) && m_actors[slot] != nullptr; }
+    CollisionShapeType GetType(int slot) const { return m_colliders[slot].type; }
+    const WorldCollider& GetCollider(int slot) const { return m_colliders[slot]; }
+    DD_Actor* GetActor(int slot) const { return m_actors[slot]; }
+
+    // World bounding box of the slot (the box itself for AABB colliders)
+    AABB GetBounds(int slot) const
+    {
+        return AABB{Vec3(m_centerX[slot], m_centerY[slot], m_centerZ[slot]), Vec3(m_halfX[slot], m_halfY[slot], m_halfZ[slot])};
+    }
+
+    // Appends the slot's bounds to the batch; the batch must not be full
+    void Gather(int slot, AABBBatch& batch) const
+    {
+        int lane = batch.count++;
+        batch.centerX[lane] = m_centerX[slot];
+        batch.centerY[lane] = m_centerY[slot];
+        batch.centerZ[lane] = m_centerZ[slot];
+        batch.halfX[lane] = m_halfX[slot];
+        batch.halfY[lane] = m_halfY[slot];
+        batch.halfZ[lane] = m_halfZ[slot];
+    }
+
+private:
+    void Grow(int slot);
+
+private:
+    std::vector<float> m_centerX, m_centerY, m_centerZ;
+    std::vector<float> m_halfX, m_halfY, m_halfZ;
+    std::vector<WorldCollider> m_colliders;
+    std::vector<DD_Actor*> m_actors;
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "DD_GLHelper.h"
+#include <cstdint>
 
 enum class CollisionShapeType
 {
@@ -9,6 +10,35 @@ enum class CollisionShapeType
     Sphere
 };
 
+// How a collider moves. Static and kinematic colliders are never tested against each other.
+enum class CollisionBodyType
+{
+    Static = 0,  // Never moves
+    Kinematic,   // Moved by code; pushes dynamic colliders but is never pushed
+    Dynamic
+};
+
+// Layer bits a collider is on, and the layer bits it collides with
+struct CollisionFilter
+{
+    uint32_t layers;
+    uint32_t mask;
+    bool dynamic;
+};
+
+inline bool operator==(const CollisionFilter& a, const CollisionFilter& b)
+{
+    return a.layers == b.layers && a.mask == b.mask && a.dynamic == b.dynamic;
+}
+
+inline bool operator!=(const CollisionFilter& a, const CollisionFilter& b) { return !(a == b); }
+
+// Each side must be on a layer the other accepts, and at least one side must be dynamic
+inline bool ShouldCollide(const CollisionFilter& a, const CollisionFilter& b)
+{
+    return (a.layers & b.mask) != 0 && (b.layers & a.mask) != 0 && (a.dynamic || b.dynamic);
+}
+
 struct AABB
 {
     Vec3 center;
@@ -28,12 +58,37 @@ struct Sphere
     float radius;
 };
 
+struct Ray
+{
+    Vec3 origin;
+    Vec3 direction;     // Normalized by the world queries
+    float maxDistance;
+};
+
 class DD_CollisionComponent
 {
 public:
-    DD_CollisionComponent() : m_type(CollisionShapeType::None), m_mass(1.0f), m_aabbHalfExtents(1.0f) {}
+    DD_CollisionComponent()
+        : m_type(CollisionShapeType::None), m_mass(1.0f), m_aabbHalfExtents(1.0f), m_radius(1.0f)
+        , m_bodyType(CollisionBodyType::Dynamic), m_layer(1u), m_mask(0xFFFFFFFFu), m_proxyId(-1) {}
+
+    CollisionFilter GetFilter() const { return { m_layer, m_mask, m_bodyType == CollisionBodyType::Dynamic }; }
+
+    // Dynamic colliders split contacts by mass; the other types act as infinitely heavy
+    float GetInverseMass() const
+    {
+        return m_bodyType == CollisionBodyType::Dynamic && m_mass > 0.0f ? 1.0f / m_mass : 0.0f;
+    }
 
     CollisionShapeType m_type;
     float m_mass;
-    Vec3 m_aabbHalfExtents;
+    Vec3 m_aabbHalfExtents;  // Half extents for AABB and OBB shapes; OBBs take the actor rotation
+    float m_radius;          // Sphere radius
+
+    CollisionBodyType m_bodyType;
+    uint32_t m_layer;        // Layer bits this collider is on
+    uint32_t m_mask;         // Layer bits it collides with
+
+    // Broadphase proxy owned by the world (-1 when not registered)
+    int m_proxyId;
 };
@@ -0,0 +1,105 @@
+#include "DD_CollisionIslands.h"
+
+DD_CollisionIslands::DD_CollisionIslands()
+{
+    m_islandStart.push_back(0);
+}
+
+DD_CollisionIslands::~DD_CollisionIslands()
+{
+}
+
+void DD_CollisionIslands::Touch(int proxy)
+{
+    if (proxy >= static_cast<int>(m_parent.size()))
+    {
+        m_parent.resize(proxy + 1, -1);
+        m_islandOf.resize(proxy + 1, -1);
+    }
+    if (m_parent[proxy] < 0)
+    {
+        m_parent[proxy] = proxy;
+        m_touched.push_back(proxy);
+    }
+}
+
+int DD_CollisionIslands::Find(int proxy)
+{
+    // Path halving
+    while (m_parent[proxy] != proxy)
+    {
+        m_parent[proxy] = m_parent[m_parent[proxy]];
+        proxy = m_parent[proxy];
+    }
+    return proxy;
+}
+
+void DD_CollisionIslands::Union(int a, int b)
+{
+    int rootA = Find(a);
+    int rootB = Find(b);
+    if (rootA == rootB) return;
+
+    // Smaller id becomes the root, which keeps the forest independent of timing
+    if (rootA < rootB) m_parent[rootB] = rootA;
+    else m_parent[rootA] = rootB;
+}
+
+void DD_CollisionIslands::Build(const std::vector<CollisionContact>& contacts, const std::vector<uint8_t>* fixedProxies)
+{
+    const int contactCount = static_cast<int>(contacts.size());
+    auto isFixed = [fixedProxies](int proxy)
+    {
+        return fixedProxies && proxy < static_cast<int>(fixedProxies->size()) && (*fixedProxies)[proxy] != 0;
+    };
+
+    for (const CollisionContact& contact : contacts)
+    {
+        const bool fixedA = isFixed(contact.proxyA);
+        const bool fixedB = isFixed(contact.proxyB);
+        if (!fixedA) Touch(contact.proxyA);
+        if (!fixedB) Touch(contact.proxyB);
+        if (!fixedA && !fixedB) Union(contact.proxyA, contact.proxyB);
+    }
+
+    // Number islands by first contact and count their contacts
+    m_islandStart.assign(1, 0);
+    m_contactIsland.resize(contactCount);
+    for (int i = 0; i < contactCount; ++i)
+    {
+        // The moving side decides the island; a fixed side may be shared by several
+        int moving = !isFixed(contacts[i].proxyA) ? contacts[i].proxyA : contacts[i].proxyB;
+        if (isFixed(moving))
+        {
+            m_contactIsland[i] = -1;
+            continue;
+        }
+
+        int root = Find(moving);
+        if (m_islandOf[root] < 0)
+        {
+            m_islandOf[root] = static_cast<int>(m_islandStart.size()) - 1;
+            m_islandStart.push_back(0);
+        }
+        int island = m_islandOf[root];
+        m_contactIsland[i] = island;
+        ++m_islandStart[island + 1];
+    }
+
+    for (size_t i = 1; i < m_islandStart.size(); ++i) m_islandStart[i] += m_islandStart[i - 1];
+
+    // Stable counting sort of contact indices by island
+    m_islandContacts.resize(m_islandStart.back());
+    m_cursor.assign(m_islandStart.begin(), m_islandStart.end() - 1);
+    for (int i = 0; i < contactCount; ++i)
+    {
+        if (m_contactIsland[i] >= 0) m_islandContacts[m_cursor[m_contactIsland[i]]++] = i;
+    }
+
+    for (int proxy : m_touched)
+    {
+        m_parent[proxy] = -1;
+        m_islandOf[proxy] = -1;
+    }
+    m_touched.clear();
+}
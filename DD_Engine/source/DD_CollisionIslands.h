@@ -0,0 +1,42 @@
+#pragma once
+#include "DD_CollisionUtils.h"
+#include <cstdint>
+#include <vector>
+
+// Splits a contact list into islands: groups of contacts that share no proxy with any
+// other group, so islands can be resolved independently. Built with union-find over
+// proxy ids. Islands are numbered by their first contact and keep contacts in list
+// order, so the result depends only on the contact list.
+//
+// Proxies flagged in fixedProxies (static and kinematic colliders, which contacts only
+// read) are left out of the union, so one ground collider does not join everything
+// resting on it into a single island. Contacts with no moving side get no island.
+class DD_CollisionIslands
+{
+public:
+    DD_CollisionIslands();
+    ~DD_CollisionIslands();
+
+    // fixedProxies is indexed by proxy id; ids past its end count as moving
+    void Build(const std::vector<CollisionContact>& contacts, const std::vector<uint8_t>* fixedProxies = nullptr);
+
+    int GetIslandCount() const { return static_cast<int>(m_islandStart.size()) - 1; }
+    int GetIslandSize(int island) const { return m_islandStart[island + 1] - m_islandStart[island]; }
+
+    // Contact indices of the island, in contact list order
+    const int* GetIslandContacts(int island) const { return m_islandContacts.data() + m_islandStart[island]; }
+
+private:
+    int Find(int proxy);
+    void Union(int a, int b);
+    void Touch(int proxy);
+
+private:
+    std::vector<int> m_parent;   // Per proxy id, -1 when unused this build
+    std::vector<int> m_islandOf; // Per root proxy id, -1 when unassigned
+    std::vector<int> m_touched;  // Proxy ids to reset after the build
+    std::vector<int> m_islandStart;
+    std::vector<int> m_islandContacts;
+    std::vector<int> m_contactIsland;
+    std::vector<int> m_cursor;
+};
@@ -1,4 +1,7 @@
 #include "DD_CollisionUtils.h"
+#include "DD_SIMD.h"
+#include "framework.h"
+#include <cfloat>
 #include <cmath>
 
 bool CollisionUtils::TestAABBvsAABB(const AABB& A, const AABB& B, Vec3& outMTV)
@@ -29,3 +32,470 @@ bool CollisionUtils::TestAABBvsAABB(const AABB& A, const AABB& B, Vec3& outMTV)
 
     return false;
 }
+
+static const Quaternion kIdentityRotation(1.0f, 0.0f, 0.0f, 0.0f);
+
+using Simd::BatchFloat;
+using Simd::kBatchLanes;
+using Simd::BatchLoad;
+using Simd::BatchSplat;
+
+uint32_t CollisionUtils::TestAABBvsAABBBatch(const AABB& A, const AABBBatch& B, Vec3 outMTV[AABBBatch::Width])
+{
+    const BatchFloat ax = BatchSplat(A.center.x), ay = BatchSplat(A.center.y), az = BatchSplat(A.center.z);
+    const BatchFloat hx = BatchSplat(A.halfExtents.x), hy = BatchSplat(A.halfExtents.y), hz = BatchSplat(A.halfExtents.z);
+    const BatchFloat zero = BatchSplat(0.0f);
+
+    uint32_t hits = 0;
+    for (int first = 0; first < B.count; first += kBatchLanes)
+    {
+        BatchFloat dx = Simd::Sub(BatchLoad(B.centerX + first), ax);
+        BatchFloat dy = Simd::Sub(BatchLoad(B.centerY + first), ay);
+        BatchFloat dz = Simd::Sub(BatchLoad(B.centerZ + first), az);
+        BatchFloat ox = Simd::Sub(Simd::Add(hx, BatchLoad(B.halfX + first)), Simd::Abs(dx));
+        BatchFloat oy = Simd::Sub(Simd::Add(hy, BatchLoad(B.halfY + first)), Simd::Abs(dy));
+        BatchFloat oz = Simd::Sub(Simd::Add(hz, BatchLoad(B.halfZ + first)), Simd::Abs(dz));
+
+        auto hit = Simd::MaskAnd(Simd::CmpGt(ox, zero), Simd::MaskAnd(Simd::CmpGt(oy, zero), Simd::CmpGt(oz, zero)));
+        uint32_t laneMask = static_cast<uint32_t>(Simd::MoveMask(hit));
+        if (laneMask == 0) continue;
+
+        // Same axis choice and tie-breaking as TestAABBvsAABB
+        auto pickX = Simd::MaskAnd(Simd::CmpLt(ox, oy), Simd::CmpLt(ox, oz));
+        auto pickY = Simd::MaskAnd(Simd::MaskNot(pickX), Simd::CmpLt(oy, oz));
+        auto pickZ = Simd::MaskNot(Simd::MaskOr(pickX, pickY));
+        BatchFloat mx = Simd::Select(pickX, Simd::Select(Simd::CmpLt(dx, zero), Simd::Sub(zero, ox), ox), zero);
+        BatchFloat my = Simd::Select(pickY, Simd::Select(Simd::CmpLt(dy, zero), Simd::Sub(zero, oy), oy), zero);
+        BatchFloat mz = Simd::Select(pickZ, Simd::Select(Simd::CmpLt(dz, zero), Simd::Sub(zero, oz), oz), zero);
+
+        float mtvX[kBatchLanes], mtvY[kBatchLanes], mtvZ[kBatchLanes];
+        Simd::Store(mtvX, mx);
+        Simd::Store(mtvY, my);
+        Simd::Store(mtvZ, mz);
+        for (int lane = 0; lane < kBatchLanes; ++lane)
+        {
+            if (laneMask & (1u << lane)) outMTV[first + lane] = Vec3(mtvX[lane], mtvY[lane], mtvZ[lane]);
+        }
+        hits |= laneMask << first;
+    }
+
+    // Lanes past count hold stale data
+    return hits & ((1u << B.count) - 1u);
+}
+
+// Edge axes must beat face axes by this much, which keeps resting contacts on face normals
+static constexpr float kEdgeAxisBias = 1.0e-3f;
+
+bool CollisionUtils::TestAABBvsOBB(const AABB& A, const OBB& B, Vec3& outMTV)
+{
+    OBB boxA{A.center, A.halfExtents, kIdentityRotation};
+    return TestOBBvsOBB(boxA, B, outMTV);
+}
+
+bool CollisionUtils::TestOBBvsOBB(const OBB& A, const OBB& B, Vec3& outMTV)
+{
+    const glm::mat3 rotA = glm::mat3_cast(A.orientation);
+    const glm::mat3 rotB = glm::mat3_cast(B.orientation);
+    const Vec3 delta = B.center - A.center;
+
+    // Candidate axes in SoA layout: 3 faces of A, 3 faces of B, 9 edge cross products.
+    // The 16th lane repeats A's first axis so every group of four is full.
+    float axisX[16], axisY[16], axisZ[16];
+    for (int i = 0; i < 3; ++i)
+    {
+        axisX[i] = rotA[i].x; axisY[i] = rotA[i].y; axisZ[i] = rotA[i].z;
+        axisX[3 + i] = rotB[i].x; axisY[3 + i] = rotB[i].y; axisZ[3 + i] = rotB[i].z;
+        for (int j = 0; j < 3; ++j)
+        {
+            Vec3 edge = glm::cross(rotA[i], rotB[j]);
+            int k = 6 + i * 3 + j;
+            axisX[k] = edge.x; axisY[k] = edge.y; axisZ[k] = edge.z;
+        }
+    }
+    axisX[15] = axisX[0]; axisY[15] = axisY[0]; axisZ[15] = axisZ[0];
+
+    Simd::Float4 ax[3], ay[3], az[3], bx[3], by[3], bz[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        ax[i] = Simd::Set1(rotA[i].x); ay[i] = Simd::Set1(rotA[i].y); az[i] = Simd::Set1(rotA[i].z);
+        bx[i] = Simd::Set1(rotB[i].x); by[i] = Simd::Set1(rotB[i].y); bz[i] = Simd::Set1(rotB[i].z);
+    }
+    const Simd::Float4 ha[3] = { Simd::Set1(A.halfExtents.x), Simd::Set1(A.halfExtents.y), Simd::Set1(A.halfExtents.z) };
+    const Simd::Float4 hb[3] = { Simd::Set1(B.halfExtents.x), Simd::Set1(B.halfExtents.y), Simd::Set1(B.halfExtents.z) };
+    const Simd::Float4 tx = Simd::Set1(delta.x), ty = Simd::Set1(delta.y), tz = Simd::Set1(delta.z);
+    const Simd::Float4 zero = Simd::Set1(0.0f);
+    const Simd::Float4 minLengthSq = Simd::Set1(DD_SMALL_NUMBER);
+    const Simd::Float4 noAxis = Simd::Set1(FLT_MAX);
+
+    float depth[16];
+    for (int g = 0; g < 16; g += 4)
+    {
+        const Simd::Float4 lx = Simd::Load(axisX + g);
+        const Simd::Float4 ly = Simd::Load(axisY + g);
+        const Simd::Float4 lz = Simd::Load(axisZ + g);
+
+        auto project = [&](Simd::Float4 ux, Simd::Float4 uy, Simd::Float4 uz)
+        {
+            return Simd::Abs(Simd::MulAdd(lx, ux, Simd::MulAdd(ly, uy, Simd::Mul(lz, uz))));
+        };
+
+        Simd::Float4 ra = Simd::Mul(ha[0], project(ax[0], ay[0], az[0]));
+        ra = Simd::MulAdd(ha[1], project(ax[1], ay[1], az[1]), ra);
+        ra = Simd::MulAdd(ha[2], project(ax[2], ay[2], az[2]), ra);
+
+        Simd::Float4 rb = Simd::Mul(hb[0], project(bx[0], by[0], bz[0]));
+        rb = Simd::MulAdd(hb[1], project(bx[1], by[1], bz[1]), rb);
+        rb = Simd::MulAdd(hb[2], project(bx[2], by[2], bz[2]), rb);
+
+        Simd::Float4 overlap = Simd::Sub(Simd::Add(ra, rb), project(tx, ty, tz));
+        Simd::Float4 lengthSq = Simd::MulAdd(lx, lx, Simd::MulAdd(ly, ly, Simd::Mul(lz, lz)));
+
+        // Cross products of near-parallel edges carry no information
+        Simd::Mask4 valid = Simd::CmpGt(lengthSq, minLengthSq);
+        if (Simd::MoveMask(Simd::MaskAnd(valid, Simd::CmpLe(overlap, zero))) != 0) return false;
+
+        Simd::Float4 axisDepth = Simd::Div(overlap, Simd::Sqrt(Simd::Max(lengthSq, minLengthSq)));
+        Simd::Store(depth + g, Simd::Select(valid, axisDepth, noAxis));
+    }
+
+    int best = 0;
+    float bestDepth = depth[0];
+    for (int k = 1; k < 15; ++k)
+    {
+        float bias = k >= 6 ? kEdgeAxisBias : 0.0f;
+        if (depth[k] + bias < bestDepth)
+        {
+            bestDepth = depth[k];
+            best = k;
+        }
+    }
+
+    Vec3 axis = glm::normalize(Vec3(axisX[best], axisY[best], axisZ[best]));
+    if (glm::dot(axis, delta) < 0.0f) axis = -axis;
+    outMTV = axis * bestDepth;
+    return true;
+}
+
+// Sphere against a box centered at the origin, everything in box space
+static bool TestLocalBoxVsSphere(const Vec3& halfExtents, const Vec3& center, float radius, Vec3& outMTV)
+{
+    Vec3 closest = glm::clamp(center, -halfExtents, halfExtents);
+    Vec3 d = center - closest;
+    float distSq = glm::dot(d, d);
+    if (distSq > DD_SMALL_NUMBER)
+    {
+        if (distSq >= radius * radius) return false;
+        float dist = sqrtf(distSq);
+        outMTV = d * ((radius - dist) / dist);
+        return true;
+    }
+
+    // Center inside the box: push out through the nearest face
+    int axis = 0;
+    float bestDepth = FLT_MAX;
+    for (int i = 0; i < 3; ++i)
+    {
+        float faceDepth = halfExtents[i] - fabsf(center[i]) + radius;
+        if (faceDepth < bestDepth)
+        {
+            bestDepth = faceDepth;
+            axis = i;
+        }
+    }
+    outMTV = Vec3(0.0f);
+    outMTV[axis] = center[axis] < 0.0f ? -bestDepth : bestDepth;
+    return true;
+}
+
+bool CollisionUtils::TestAABBvsSphere(const AABB& A, const Sphere& B, Vec3& outMTV)
+{
+    return TestLocalBoxVsSphere(A.halfExtents, B.center - A.center, B.radius, outMTV);
+}
+
+bool CollisionUtils::TestOBBvsSphere(const OBB& A, const Sphere& B, Vec3& outMTV)
+{
+    Vec3 local = glm::conjugate(A.orientation) * (B.center - A.center);
+    Vec3 localMTV;
+    if (!TestLocalBoxVsSphere(A.halfExtents, local, B.radius, localMTV)) return false;
+    outMTV = A.orientation * localMTV;
+    return true;
+}
+
+bool CollisionUtils::TestSphereVsSphere(const Sphere& A, const Sphere& B, Vec3& outMTV)
+{
+    Vec3 delta = B.center - A.center;
+    float radiusSum = A.radius + B.radius;
+    float distSq = glm::dot(delta, delta);
+    if (distSq >= radiusSum * radiusSum) return false;
+
+    float dist = sqrtf(distSq);
+    Vec3 normal = dist > DD_SMALL_NUMBER ? delta / dist : Vec3(0.0f, 1.0f, 0.0f);
+    outMTV = normal * (radiusSum - dist);
+    return true;
+}
+
+AABB CollisionUtils::ComputeBounds(const OBB& box)
+{
+    const glm::mat3 rot = glm::mat3_cast(box.orientation);
+    Vec3 extents = glm::abs(rot[0]) * box.halfExtents.x
+                 + glm::abs(rot[1]) * box.halfExtents.y
+                 + glm::abs(rot[2]) * box.halfExtents.z;
+    return AABB{box.center, extents};
+}
+
+AABB CollisionUtils::ComputeBounds(const Sphere& sphere)
+{
+    return AABB{sphere.center, Vec3(sphere.radius)};
+}
+
+AABB CollisionUtils::ComputeBounds(const WorldCollider& collider)
+{
+    switch (collider.type)
+    {
+    case CollisionShapeType::AABB:
+        return AABB{collider.box.center, collider.box.halfExtents};
+    case CollisionShapeType::OBB:
+        return ComputeBounds(collider.box);
+    case CollisionShapeType::Sphere:
+        return ComputeBounds(collider.sphere);
+    default:
+        return AABB{collider.box.center, Vec3(0.0f)};
+    }
+}
+
+WorldCollider CollisionUtils::MakeWorldCollider(const DD_CollisionComponent& col, const Vec3& position, const Quaternion& rotation)
+{
+    WorldCollider collider;
+    collider.type = col.m_type;
+    collider.box.center = position;
+    collider.box.halfExtents = col.m_aabbHalfExtents;
+    collider.box.orientation = col.m_type == CollisionShapeType::OBB ? rotation : kIdentityRotation;
+    collider.sphere.center = position;
+    collider.sphere.radius = col.m_radius;
+    return collider;
+}
+
+bool CollisionUtils::TestColliders(const WorldCollider& A, const WorldCollider& B, Vec3& outMTV)
+{
+    const AABB boxA{A.box.center, A.box.halfExtents};
+    const AABB boxB{B.box.center, B.box.halfExtents};
+
+    switch (A.type)
+    {
+    case CollisionShapeType::AABB:
+        switch (B.type)
+        {
+        case CollisionShapeType::AABB: return TestAABBvsAABB(boxA, boxB, outMTV);
+        case CollisionShapeType::OBB: return TestAABBvsOBB(boxA, B.box, outMTV);
+        case CollisionShapeType::Sphere: return TestAABBvsSphere(boxA, B.sphere, outMTV);
+        default: return false;
+        }
+    case CollisionShapeType::OBB:
+        switch (B.type)
+        {
+        case CollisionShapeType::AABB:
+            if (!TestAABBvsOBB(boxB, A.box, outMTV)) return false;
+            outMTV = -outMTV;
+            return true;
+        case CollisionShapeType::OBB: return TestOBBvsOBB(A.box, B.box, outMTV);
+        case CollisionShapeType::Sphere: return TestOBBvsSphere(A.box, B.sphere, outMTV);
+        default: return false;
+        }
+    case CollisionShapeType::Sphere:
+        switch (B.type)
+        {
+        case CollisionShapeType::AABB:
+            if (!TestAABBvsSphere(boxB, A.sphere, outMTV)) return false;
+            outMTV = -outMTV;
+            return true;
+        case CollisionShapeType::OBB:
+            if (!TestOBBvsSphere(B.box, A.sphere, outMTV)) return false;
+            outMTV = -outMTV;
+            return true;
+        case CollisionShapeType::Sphere: return TestSphereVsSphere(A.sphere, B.sphere, outMTV);
+        default: return false;
+        }
+    default:
+        return false;
+    }
+}
+
+// Large stand-in for 1/0 that keeps slab math free of inf * 0
+static inline float SafeInverse(float d)
+{
+    return fabsf(d) > DD_SMALL_NUMBER ? 1.0f / d : (d < 0.0f ? -1e30f : 1e30f);
+}
+
+void RayPacket::Reset()
+{
+    for (int lane = 0; lane < Width; ++lane)
+    {
+        originX[lane] = originY[lane] = originZ[lane] = 0.0f;
+        invDirX[lane] = invDirY[lane] = invDirZ[lane] = 1.0f;
+        maxT[lane] = -1.0f;
+    }
+    count = 0;
+}
+
+void RayPacket::Add(const Vec3& origin, const Vec3& dir, float rayMaxT)
+{
+    int lane = count++;
+    originX[lane] = origin.x;
+    originY[lane] = origin.y;
+    originZ[lane] = origin.z;
+    invDirX[lane] = SafeInverse(dir.x);
+    invDirY[lane] = SafeInverse(dir.y);
+    invDirZ[lane] = SafeInverse(dir.z);
+    maxT[lane] = rayMaxT;
+}
+
+AABB RayPacket::GetBounds() const
+{
+    Vec3 lower(FLT_MAX), upper(-FLT_MAX);
+    for (int lane = 0; lane < count; ++lane)
+    {
+        Vec3 origin(originX[lane], originY[lane], originZ[lane]);
+        Vec3 dir(1.0f / invDirX[lane], 1.0f / invDirY[lane], 1.0f / invDirZ[lane]);
+        Vec3 end = origin + dir * maxT[lane];
+        lower = glm::min(lower, glm::min(origin, end));
+        upper = glm::max(upper, glm::max(origin, end));
+    }
+    if (count == 0) return AABB{Vec3(0.0f), Vec3(0.0f)};
+    return AABB{(lower + upper) * 0.5f, (upper - lower) * 0.5f};
+}
+
+int CollisionUtils::TestRayPacketVsBox(const RayPacket& packet, const Vec3& lower, const Vec3& upper)
+{
+    Simd::Float4 tMin = Simd::Set1(0.0f);
+    Simd::Float4 tMax = Simd::Load(packet.maxT);
+
+    const float* origins[3] = { packet.originX, packet.originY, packet.originZ };
+    const float* invDirs[3] = { packet.invDirX, packet.invDirY, packet.invDirZ };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        Simd::Float4 origin = Simd::Load(origins[axis]);
+        Simd::Float4 invDir = Simd::Load(invDirs[axis]);
+        Simd::Float4 t1 = Simd::Mul(Simd::Sub(Simd::Set1(lower[axis]), origin), invDir);
+        Simd::Float4 t2 = Simd::Mul(Simd::Sub(Simd::Set1(upper[axis]), origin), invDir);
+        tMin = Simd::Max(tMin, Simd::Min(t1, t2));
+        tMax = Simd::Min(tMax, Simd::Max(t1, t2));
+    }
+
+    // Empty lanes have maxT < 0 and fail here
+    return Simd::MoveMask(Simd::CmpLe(tMin, tMax)) & ((1 << packet.count) - 1);
+}
+
+bool CollisionUtils::RayVsAABB(const Vec3& origin, const Vec3& dir, float maxT, const AABB& box, float& outT, Vec3& outNormal)
+{
+    float tMin = 0.0f, tMax = maxT;
+    int hitAxis = -1;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float invDir = SafeInverse(dir[axis]);
+        float t1 = (box.center[axis] - box.halfExtents[axis] - origin[axis]) * invDir;
+        float t2 = (box.center[axis] + box.halfExtents[axis] - origin[axis]) * invDir;
+        if (t1 > t2) { float t = t1; t1 = t2; t2 = t; }
+        if (t1 > tMin)
+        {
+            tMin = t1;
+            hitAxis = axis;
+        }
+        if (t2 < tMax) tMax = t2;
+        if (tMin > tMax) return false;
+    }
+
+    outT = tMin;
+    if (hitAxis < 0)
+    {
+        // Started inside
+        float len = glm::length(dir);
+        outNormal = len > DD_SMALL_NUMBER ? -dir / len : Vec3(0.0f, 1.0f, 0.0f);
+        return true;
+    }
+    outNormal = Vec3(0.0f);
+    outNormal[hitAxis] = dir[hitAxis] > 0.0f ? -1.0f : 1.0f;
+    return true;
+}
+
+bool CollisionUtils::SweepAABBvsAABB(const AABB& A, const Vec3& delta, const AABB& B, float& outTOI, Vec3& outNormal)
+{
+    // Ray cast of A's center against B grown by A's extents
+    const AABB expanded{B.center, B.halfExtents + A.halfExtents};
+    float tEnter = 0.0f, tExit = 1.0f;
+    int hitAxis = -1;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float invDir = SafeInverse(delta[axis]);
+        float t1 = (expanded.center[axis] - expanded.halfExtents[axis] - A.center[axis]) * invDir;
+        float t2 = (expanded.center[axis] + expanded.halfExtents[axis] - A.center[axis]) * invDir;
+        if (t1 > t2) { float t = t1; t1 = t2; t2 = t; }
+        // A face touching at t = 0 still counts as an entry when moving into it
+        if (t1 > tEnter || (t1 == tEnter && hitAxis < 0 && delta[axis] != 0.0f))
+        {
+            tEnter = t1;
+            hitAxis = axis;
+        }
+        if (t2 < tExit) tExit = t2;
+        if (tEnter >= tExit) return false;
+    }
+    if (hitAxis < 0) return false;
+
+    outTOI = tEnter;
+    outNormal = Vec3(0.0f);
+    outNormal[hitAxis] = delta[hitAxis] > 0.0f ? -1.0f : 1.0f;
+    return true;
+}
+
+bool CollisionUtils::RayVsOBB(const Vec3& origin, const Vec3& dir, float maxT, const OBB& box, float& outT, Vec3& outNormal)
+{
+    const Quaternion inverse = glm::conjugate(box.orientation);
+    Vec3 localOrigin = inverse * (origin - box.center);
+    Vec3 localDir = inverse * dir;
+    Vec3 localNormal;
+    if (!RayVsAABB(localOrigin, localDir, maxT, AABB{Vec3(0.0f), box.halfExtents}, outT, localNormal)) return false;
+    outNormal = box.orientation * localNormal;
+    return true;
+}
+
+bool CollisionUtils::RayVsSphere(const Vec3& origin, const Vec3& dir, float maxT, const Sphere& sphere, float& outT, Vec3& outNormal)
+{
+    Vec3 m = origin - sphere.center;
+    float c = glm::dot(m, m) - sphere.radius * sphere.radius;
+    if (c <= 0.0f)
+    {
+        float len = glm::length(dir);
+        outT = 0.0f;
+        outNormal = len > DD_SMALL_NUMBER ? -dir / len : Vec3(0.0f, 1.0f, 0.0f);
+        return true;
+    }
+
+    float a = glm::dot(dir, dir);
+    if (a < DD_SMALL_NUMBER) return false;
+    float b = glm::dot(m, dir);
+    if (b > 0.0f) return false;  // Outside and pointing away
+
+    float disc = b * b - a * c;
+    if (disc < 0.0f) return false;
+
+    float t = (-b - sqrtf(disc)) / a;
+    if (t > maxT) return false;
+
+    outT = t;
+    outNormal = (m + dir * t) / sphere.radius;
+    return true;
+}
+
+bool CollisionUtils::RayVsCollider(const Vec3& origin, const Vec3& dir, float maxT, const WorldCollider& collider, float& outT, Vec3& outNormal)
+{
+    switch (collider.type)
+    {
+    case CollisionShapeType::AABB:
+        return RayVsAABB(origin, dir, maxT, AABB{collider.box.center, collider.box.halfExtents}, outT, outNormal);
+    case CollisionShapeType::OBB:
+        return RayVsOBB(origin, dir, maxT, collider.box, outT, outNormal);
+    case CollisionShapeType::Sphere:
+        return RayVsSphere(origin, dir, maxT, collider.sphere, outT, outNormal);
+    default:
+        return false;
+    }
+}
@@ -1,9 +1,98 @@
 #pragma once
 #include "DD_CollisionComponent.h"
 
+// Collider shape placed in world space. AABB uses box.center/halfExtents only.
+struct WorldCollider
+{
+    CollisionShapeType type = CollisionShapeType::None;
+    OBB box;
+    Sphere sphere;
+};
+
+// Up to Width boxes in SoA layout, filled by DD_ColliderCache::Gather
+struct AABBBatch
+{
+    static constexpr int Width = 8;
+
+    float centerX[Width] = {};
+    float centerY[Width] = {};
+    float centerZ[Width] = {};
+    float halfX[Width] = {};
+    float halfY[Width] = {};
+    float halfZ[Width] = {};
+    int count = 0;
+};
+
+// Up to Width rays in SoA layout for packet slab tests. Empty lanes never hit.
+struct RayPacket
+{
+    static constexpr int Width = 4;
+
+    float originX[Width];
+    float originY[Width];
+    float originZ[Width];
+    float invDirX[Width];
+    float invDirY[Width];
+    float invDirZ[Width];
+    float maxT[Width];
+    int count;
+
+    RayPacket() { Reset(); }
+    void Reset();
+    // dir need not be normalized; hits are reported in units of dir
+    void Add(const Vec3& origin, const Vec3& dir, float maxT);
+    // Box around every segment in the packet
+    AABB GetBounds() const;
+};
+
+// Narrowphase result for one broadphase pair
+struct CollisionContact
+{
+    int proxyA;
+    int proxyB;
+    Vec3 mtv;  // Separates B from A
+};
+
 class CollisionUtils
 {
 public:
     // Test AABB vs AABB. Returns true if colliding and sets outMTV to the minimum translation vector to separate B from A.
     static bool TestAABBvsAABB(const AABB& A, const AABB& B, Vec3& outMTV);
+
+    // Tests A against every box in the batch, 8 lanes per instruction with AVX2 and 4 otherwise.
+    // Returns a hit mask (bit i = lane i); outMTV[i] matches TestAABBvsAABB for every hit lane.
+    static uint32_t TestAABBvsAABBBatch(const AABB& A, const AABBBatch& B, Vec3 outMTV[AABBBatch::Width]);
+
+    // Pair tests below follow the same convention: outMTV pushes B away from A
+    static bool TestAABBvsOBB(const AABB& A, const OBB& B, Vec3& outMTV);
+    static bool TestAABBvsSphere(const AABB& A, const Sphere& B, Vec3& outMTV);
+    // 15-axis separating axis test, evaluated four axes at a time with SIMD
+    static bool TestOBBvsOBB(const OBB& A, const OBB& B, Vec3& outMTV);
+    static bool TestOBBvsSphere(const OBB& A, const Sphere& B, Vec3& outMTV);
+    static bool TestSphereVsSphere(const Sphere& A, const Sphere& B, Vec3& outMTV);
+
+    // Ray tests. The ray is origin + dir * t for t in [0, maxT]; a ray starting inside
+    // the shape hits at t = 0 with the normal facing back along dir.
+    static bool RayVsAABB(const Vec3& origin, const Vec3& dir, float maxT, const AABB& box, float& outT, Vec3& outNormal);
+    static bool RayVsOBB(const Vec3& origin, const Vec3& dir, float maxT, const OBB& box, float& outT, Vec3& outNormal);
+    static bool RayVsSphere(const Vec3& origin, const Vec3& dir, float maxT, const Sphere& sphere, float& outT, Vec3& outNormal);
+    static bool RayVsCollider(const Vec3& origin, const Vec3& dir, float maxT, const WorldCollider& collider, float& outT, Vec3& outNormal);
+
+    // Time of impact of box A moving by delta against a resting box B, as a fraction of
+    // delta in [0, 1]. Boxes that already overlap at the start report no impact.
+    static bool SweepAABBvsAABB(const AABB& A, const Vec3& delta, const AABB& B, float& outTOI, Vec3& outNormal);
+
+    // Slab test of every ray in the packet against a box in one pass. Returns a lane mask
+    // of the rays whose segment touches [lower, upper].
+    static int TestRayPacketVsBox(const RayPacket& packet, const Vec3& lower, const Vec3& upper);
+
+    // World-space bounding boxes used by the broadphase
+    static AABB ComputeBounds(const OBB& box);
+    static AABB ComputeBounds(const Sphere& sphere);
+    static AABB ComputeBounds(const WorldCollider& collider);
+
+    static WorldCollider MakeWorldCollider(const DD_CollisionComponent& col, const Vec3& position, const Quaternion& rotation);
+
+    // Dispatches on both shape types
+    static bool TestColliders(const WorldCollider& A, const WorldCollider& B, Vec3& outMTV);
 };
@@ -0,0 +1,153 @@
+#include "DD_CommandBuffer.h"
+#include "DD_Actor.h"
+
+DD_CommandBuffer::DD_CommandBuffer()
+    : m_commandCount(0)
+{
+}
+
+DD_CommandBuffer::~DD_CommandBuffer()
+{
+    // Nothing was constructed for spawns that were never applied
+    Reset();
+}
+
+DD_CommandBuffer::PendingActor DD_CommandBuffer::RecordSpawn(CreateFn create, const Transform& transform)
+{
+    SpawnCommand* command = m_arena.New<SpawnCommand>();
+    command->create = create;
+    command->transform = transform;
+    command->actor = nullptr;
+    m_spawns.Append(command);
+    ++m_commandCount;
+    return PendingActor(command);
+}
+
+void DD_CommandBuffer::Destroy(ActorHandle actor)
+{
+    DestroyCommand* command = m_arena.New<DestroyCommand>();
+    command->actor = actor;
+    m_destroys.Append(command);
+    ++m_commandCount;
+}
+
+DD_CommandBuffer::AttachCommand* DD_CommandBuffer::RecordAttach(AttachKind kind, const Target& target)
+{
+    AttachCommand* command = m_arena.New<AttachCommand>();
+    command->kind = kind;
+    command->target = target;
+    command->mesh = nullptr;
+    command->material = nullptr;
+    command->velocity = Vec3(0.0f);
+    m_attachments.Append(command);
+    ++m_commandCount;
+    return command;
+}
+
+void DD_CommandBuffer::AttachMesh(ActorHandle actor, DD_Mesh* mesh, DD_Material* material)
+{
+    AttachCommand* command = RecordAttach(AttachKind::Mesh, Target{actor, nullptr});
+    command->mesh = mesh;
+    command->material = material;
+}
+
+void DD_CommandBuffer::AttachMesh(PendingActor actor, DD_Mesh* mesh, DD_Material* material)
+{
+    if (!actor.m_spawn) return;
+    AttachCommand* command = RecordAttach(AttachKind::Mesh, Target{ActorHandle(), actor.m_spawn});
+    command->mesh = mesh;
+    command->material = material;
+}
+
+void DD_CommandBuffer::AttachCollision(ActorHandle actor, const DD_CollisionComponent& collider)
+{
+    RecordAttach(AttachKind::Collision, Target{actor, nullptr})->collider = collider;
+}
+
+void DD_CommandBuffer::AttachCollision(PendingActor actor, const DD_CollisionComponent& collider)
+{
+    if (!actor.m_spawn) return;
+    RecordAttach(AttachKind::Collision, Target{ActorHandle(), actor.m_spawn})->collider = collider;
+}
+
+void DD_CommandBuffer::AttachRigidBody(ActorHandle actor, const Vec3& velocity)
+{
+    RecordAttach(AttachKind::RigidBody, Target{actor, nullptr})->velocity = velocity;
+}
+
+void DD_CommandBuffer::AttachRigidBody(PendingActor actor, const Vec3& velocity)
+{
+    if (!actor.m_spawn) return;
+    RecordAttach(AttachKind::RigidBody, Target{ActorHandle(), actor.m_spawn})->velocity = velocity;
+}
+
+DD_Actor* DD_CommandBuffer::Resolve(DD_World& world, const Target& target) const
+{
+    if (target.spawn) return target.spawn->actor;
+    return world.GetActor(target.handle);
+}
+
+void DD_CommandBuffer::ApplySpawns(DD_World& world)
+{
+    for (SpawnCommand* command = m_spawns.head; command; command = command->next)
+    {
+        std::unique_ptr<DD_Actor> actor(command->create());
+        actor->SetTransform(command->transform);
+        command->actor = actor.get();
+        world.AddActor(std::move(actor));
+    }
+}
+
+void DD_CommandBuffer::ApplyAttachments(DD_World& world)
+{
+    for (AttachCommand* command = m_attachments.head; command; command = command->next)
+    {
+        DD_Actor* actor = Resolve(world, command->target);
+        if (!actor) continue;  // Destroyed before the buffer was applied
+
+        switch (command->kind)
+        {
+        case AttachKind::Mesh:
+        {
+            DD_MeshComponent* mesh = world.AddMeshComponent(actor);
+            mesh->SetMesh(command->mesh);
+            mesh->SetMaterial(command->material);
+            break;
+        }
+        case AttachKind::Collision:
+        {
+            // Keep the proxy of a collider the actor already had
+            DD_CollisionComponent* collider = world.AddCollisionComponent(actor);
+            if (!collider) break;
+            const int proxyId = collider->m_proxyId;
+            *collider = command->collider;
+            collider->m_proxyId = proxyId;
+            break;
+        }
+        case AttachKind::RigidBody:
+        {
+            DD_RigidBodyComponent* body = world.CreateRigidBody(actor);
+            if (body) body->SetVelocity(command->velocity);
+            break;
+        }
+        }
+    }
+}
+
+void DD_CommandBuffer::ApplyDestroys(DD_World& world)
+{
+    // Stale handles, including a second destroy of the same actor, are ignored
+    for (DestroyCommand* command = m_destroys.head; command; command = command->next)
+    {
+        world.RemoveActor(command->actor);
+    }
+}
+
+void DD_CommandBuffer::Reset()
+{
+    m_spawns = List<SpawnCommand>();
+    m_attachments = List<AttachCommand>();
+    m_destroys = List<DestroyCommand>();
+    m_commandCount = 0;
+    m_arena.Reset();
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include "DD_CollisionComponent.h"
+#include "DD_FrameArena.h"
+#include "DD_Transform.h"
+#include "DD_World.h"
+
+class DD_Actor;
+class DD_Mesh;
+class DD_Material;
+
+// Structural world changes recorded while the world is being iterated and applied later
+// in one batch. Every thread records into its own buffer (DD_World::GetCommandBuffer),
+// so recording takes no locks, and commands live in a frame arena, so it takes no heap
+// allocations once the arena has warmed up.
+//
+// Applying runs all spawns, then all component attachments, then all destroys, so an
+// attachment can target an actor spawned by the same buffer and a destroy never leaves
+// another command pointing at a removed actor.
+class DD_CommandBuffer
+{
+private:
+    struct SpawnCommand;
+
+public:
+    // An actor spawned by this buffer; valid as an attach target until the buffer is applied
+    class PendingActor
+    {
+    public:
+        PendingActor() : m_spawn(nullptr) {}
+    private:
+        friend class DD_CommandBuffer;
+        explicit PendingActor(SpawnCommand* spawn) : m_spawn(spawn) {}
+        SpawnCommand* m_spawn;
+    };
+
+    DD_CommandBuffer();
+    ~DD_CommandBuffer();
+
+    DD_CommandBuffer(const DD_CommandBuffer&) = delete;
+    DD_CommandBuffer& operator=(const DD_CommandBuffer&) = delete;
+
+    // The actor is default constructed when the buffer is applied, not here: actor
+    // construction allocates a transform slot and must happen on the applying thread.
+    template<typename T>
+    PendingActor Spawn(const Transform& transform = Transform())
+    {
+        static_assert(std::is_base_of<DD_Actor, T>::value, "spawned type must derive from DD_Actor");
+        return RecordSpawn(&CreateActor<T>, transform);
+    }
+
+    void Destroy(ActorHandle actor);
+
+    void AttachMesh(ActorHandle actor, DD_Mesh* mesh, DD_Material* material);
+    void AttachMesh(PendingActor actor, DD_Mesh* mesh, DD_Material* material);
+
+    // Copies the shape, mass, body type and layers of collider
+    void AttachCollision(ActorHandle actor, const DD_CollisionComponent& collider);
+    void AttachCollision(PendingActor actor, const DD_CollisionComponent& collider);
+
+    void AttachRigidBody(ActorHandle actor, const Vec3& velocity = Vec3(0.0f));
+    void AttachRigidBody(PendingActor actor, const Vec3& velocity = Vec3(0.0f));
+
+    bool IsEmpty() const { return m_commandCount == 0; }
+    uint32_t GetCommandCount() const { return m_commandCount; }
+
+    // Applied by DD_World after PostTick, in this order, then reset
+    void ApplySpawns(DD_World& world);
+    void ApplyAttachments(DD_World& world);
+    void ApplyDestroys(DD_World& world);
+    void Reset();
+
+private:
+    typedef DD_Actor* (*CreateFn)();
+
+    template<typename T>
+    static DD_Actor* CreateActor() { return new T(); }
+
+    enum class AttachKind : uint8_t
+    {
+        Mesh,
+        Collision,
+        RigidBody
+    };
+
+    // Target of an attachment: a live actor, or one spawned by this buffer
+    struct Target
+    {
+        ActorHandle handle;
+        SpawnCommand* spawn;
+    };
+
+    struct SpawnCommand
+    {
+        CreateFn create;
+        Transform transform;
+        DD_Actor* actor;  // Set once applied
+        SpawnCommand* next;
+    };
+
+    struct AttachCommand
+    {
+        AttachKind kind;
+        Target target;
+        DD_Mesh* mesh;
+        DD_Material* material;
+        DD_CollisionComponent collider;
+        Vec3 velocity;
+        AttachCommand* next;
+    };
+
+    struct DestroyCommand
+    {
+        ActorHandle actor;
+        DestroyCommand* next;
+    };
+
+    PendingActor RecordSpawn(CreateFn create, const Transform& transform);
+    AttachCommand* RecordAttach(AttachKind kind, const Target& target);
+    DD_Actor* Resolve(DD_World& world, const Target& target) const;
+
+    // Commands in recording order, kept as one list per apply phase
+    template<typename C>
+    struct List
+    {
+        C* head = nullptr;
+        C* tail = nullptr;
+
+        void Append(C* command)
+        {
+            command->next = nullptr;
+            if (tail) tail->next = command;
+            else head = command;
+            tail = command;
+        }
+    };
+
+    DD_FrameArena m_arena;
+    List<SpawnCommand> m_spawns;
+    List<AttachCommand> m_attachments;
+    List<DestroyCommand> m_destroys;
+    uint32_t m_commandCount;
+};
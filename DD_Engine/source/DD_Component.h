@@ -9,16 +9,26 @@ enum class ComponentType
     Mesh,
     Collision,
     Light,
-    Camera
+    Camera,
+    RigidBody,
+    Count
 };
 
+static constexpr int kComponentTypeCount = static_cast<int>(ComponentType::Count);
+
 class DD_Component
 {
 public:
     DD_Component();
     virtual ~DD_Component();
 
-    virtual ComponentType GetType() const { return ComponentType::None; }
+    // Subclasses with their own ComponentType shadow this and SlotClass; DD_Actor uses
+    // StaticType as the slot index in GetComponent<T>(). Further subclasses inherit both,
+    // so SlotClass tells the declaring class apart from them.
+    static constexpr ComponentType StaticType = ComponentType::None;
+    typedef DD_Component SlotClass;
+
+    virtual ComponentType GetType() const { return StaticType; }
     virtual void OnAttach(DD_Actor* owner) { m_owner = owner; }
     virtual void OnDetach() { m_owner = nullptr; }
     virtual void Update(float deltaTime) {}
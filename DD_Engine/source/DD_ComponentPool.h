@@ -0,0 +1,143 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Sparse set of components of one type, keyed by entity id.
+// Components are stored by value in a packed array and found through a sparse index, so
+// iteration is a linear walk over contiguous memory. Removal moves the last component into
+// the hole and growth may reallocate, so addresses are not stable: the relocation callback
+// reports every component that moved so owners can refresh their cached pointers.
+template<typename T>
+class DD_ComponentPool
+{
+public:
+    static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+    typedef std::function<void(uint32_t entity, T* component)> RelocateFn;
+
+    void SetRelocateCallback(RelocateFn fn) { m_relocate = std::move(fn); }
+
+    // Returns the existing component if the entity already has one
+    T* Add(uint32_t entity)
+    {
+        if (Has(entity)) return &m_dense[m_sparse[entity]];
+        if (entity >= m_sparse.size()) m_sparse.resize(entity + 1, InvalidIndex);
+
+        const T* oldData = m_dense.data();
+        m_sparse[entity] = static_cast<uint32_t>(m_dense.size());
+        m_dense.emplace_back();
+        m_entities.push_back(entity);
+
+        // A reallocation moved everything before the new component
+        if (m_dense.data() != oldData && m_relocate)
+        {
+            for (size_t i = 0; i + 1 < m_dense.size(); ++i) m_relocate(m_entities[i], &m_dense[i]);
+        }
+        return &m_dense.back();
+    }
+
+    void Remove(uint32_t entity)
+    {
+        if (!Has(entity)) return;
+
+        const uint32_t index = m_sparse[entity];
+        const uint32_t last = static_cast<uint32_t>(m_dense.size()) - 1;
+        m_sparse[entity] = InvalidIndex;
+        if (index != last)
+        {
+            m_dense[index] = std::move(m_dense[last]);
+            m_entities[index] = m_entities[last];
+            m_sparse[m_entities[index]] = index;
+            if (m_relocate) m_relocate(m_entities[index], &m_dense[index]);
+        }
+        m_dense.pop_back();
+        m_entities.pop_back();
+    }
+
+    bool Has(uint32_t entity) const { return entity < m_sparse.size() && m_sparse[entity] != InvalidIndex; }
+    T* Get(uint32_t entity) { return Has(entity) ? &m_dense[m_sparse[entity]] : nullptr; }
+    const T* Get(uint32_t entity) const { return Has(entity) ? &m_dense[m_sparse[entity]] : nullptr; }
+
+    // Packed access, index in [0, Size())
+    uint32_t Size() const { return static_cast<uint32_t>(m_dense.size()); }
+    T& At(uint32_t index) { return m_dense[index]; }
+    const T& At(uint32_t index) const { return m_dense[index]; }
+    uint32_t GetEntity(uint32_t index) const { return m_entities[index]; }
+
+    T* begin() { return m_dense.data(); }
+    T* end() { return m_dense.data() + m_dense.size(); }
+    const T* begin() const { return m_dense.data(); }
+    const T* end() const { return m_dense.data() + m_dense.size(); }
+
+private:
+    std::vector<T> m_dense;
+    std::vector<uint32_t> m_entities;  // Entity of each packed component
+    std::vector<uint32_t> m_sparse;    // Packed index per entity, InvalidIndex when absent
+    RelocateFn m_relocate;
+};
+
+template<typename T>
+constexpr uint32_t DD_ComponentPool<T>::InvalidIndex;
+
+// Entities that have both an A and a B, walked in A's packed order.
+// Pass the smaller pool as A; each step is one sparse lookup into B.
+//
+//   for (auto item : world.View<DD_RigidBodyComponent, DD_CollisionComponent>())
+//       item.a.WakeUp();
+template<typename A, typename B>
+class DD_View
+{
+public:
+    struct Item
+    {
+        uint32_t entity;
+        A& a;
+        B& b;
+    };
+
+    class Iterator
+    {
+    public:
+        Iterator(DD_ComponentPool<A>& a, DD_ComponentPool<B>& b, uint32_t index)
+            : m_a(a), m_b(b), m_index(index) { SkipMissing(); }
+
+        Item operator*() const
+        {
+            const uint32_t entity = m_a.GetEntity(m_index);
+            return { entity, m_a.At(m_index), *m_b.Get(entity) };
+        }
+        Iterator& operator++() { ++m_index; SkipMissing(); return *this; }
+        bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+
+    private:
+        void SkipMissing()
+        {
+            while (m_index < m_a.Size() && !m_b.Has(m_a.GetEntity(m_index))) ++m_index;
+        }
+
+        DD_ComponentPool<A>& m_a;
+        DD_ComponentPool<B>& m_b;
+        uint32_t m_index;
+    };
+
+    DD_View(DD_ComponentPool<A>& a, DD_ComponentPool<B>& b) : m_a(a), m_b(b) {}
+
+    Iterator begin() const { return Iterator(m_a, m_b, 0); }
+    Iterator end() const { return Iterator(m_a, m_b, m_a.Size()); }
+
+    // fn(uint32_t entity, A&, B&)
+    template<typename Fn>
+    void Each(Fn&& fn) const
+    {
+        for (uint32_t i = 0; i < m_a.Size(); ++i)
+        {
+            B* b = m_b.Get(m_a.GetEntity(i));
+            if (b) fn(m_a.GetEntity(i), m_a.At(i), *b);
+        }
+    }
+
+private:
+    DD_ComponentPool<A>& m_a;
+    DD_ComponentPool<B>& m_b;
+};
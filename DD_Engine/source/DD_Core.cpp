@@ -1,9 +1,11 @@
 #include "DD_Core.h"
 #include "DD_GLDevice.h"
+#include "DD_JobSystem.h"
 #include "DD_Application.h"
 #include "DD_SimpleBox.h"
 #include "DD_World.h"
 #include "DD_CameraController.h"
+#include <cmath>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -19,6 +21,7 @@ void DD_Core::OnInit()
 	printf("DD_Core::OnInit()\n");
 
 	systems.push_back(DD_GLDevice::GetInstance());
+	systems.push_back(DD_JobSystem::GetInstance());
 
 	for (const auto& system : systems)
 	{
@@ -87,7 +90,23 @@ void DD_Core::OnUpdate()
 	// Update camera controller
 	if (m_camController) m_camController->Update(m_deltaTime);
 
-	m_world->Update(m_deltaTime);
+	// Fixed-step simulation, independent of the frame rate
+	m_accumulator += m_deltaTime;
+	int steps = 0;
+	while (m_accumulator >= m_fixedDeltaTime && steps < m_maxStepsPerFrame)
+	{
+		m_world->Update(m_fixedDeltaTime);
+		m_accumulator -= m_fixedDeltaTime;
+		++steps;
+	}
+	if (m_accumulator >= m_fixedDeltaTime)
+	{
+		// Too far behind: drop whole steps, keep the fraction for interpolation
+		m_accumulator = std::fmod(m_accumulator, m_fixedDeltaTime);
+	}
+
+	// Render between the last two steps
+	m_world->SetInterpolationAlpha(m_accumulator / m_fixedDeltaTime);
 
 	for (const auto& system : systems)
 	{
@@ -20,6 +20,13 @@ public:
     DD_Core(int width, int height, const char* name);
     virtual ~DD_Core();
 
+    // The world simulates in fixed steps of 1/hz seconds and renders in between
+    void SetTickRate(float hz) { if (hz > 0.0f) m_fixedDeltaTime = 1.0f / hz; }
+    float GetTickRate() const { return 1.0f / m_fixedDeltaTime; }
+    // Steps run at most per frame; time beyond that is dropped so a slow frame cannot snowball
+    void SetMaxStepsPerFrame(int steps) { m_maxStepsPerFrame = steps > 0 ? steps : 1; }
+    int GetMaxStepsPerFrame() const { return m_maxStepsPerFrame; }
+
 private:
     void SetupInputCallbacks();
 
@@ -27,5 +34,8 @@ private:
     std::vector<ISystem*> systems;
     DD_World* m_world;
     DD_CameraController* m_camController = nullptr;
-    float m_deltaTime = 0.016f;
+    float m_deltaTime = 0.016f;       // Frame time
+    float m_fixedDeltaTime = 1.0f / 60.0f;
+    int m_maxStepsPerFrame = 4;
+    float m_accumulator = 0.0f;       // Frame time not simulated yet
 };
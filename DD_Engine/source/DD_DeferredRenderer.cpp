@@ -10,16 +10,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 // Static shader variables
-GLuint DD_DeferredRenderer::s_geometryProgram = 0;
-GLint DD_DeferredRenderer::s_geoModelLoc = -1;
-GLint DD_DeferredRenderer::s_geoViewLoc = -1;
-GLint DD_DeferredRenderer::s_geoProjLoc = -1;
-GLint DD_DeferredRenderer::s_geoAlbedoLoc = -1;
-GLint DD_DeferredRenderer::s_geoMetallicLoc = -1;
-GLint DD_DeferredRenderer::s_geoRoughnessLoc = -1;
-GLint DD_DeferredRenderer::s_geoAOLoc = -1;
-GLint DD_DeferredRenderer::s_geoHasAlbedoTexLoc = -1;
-GLint DD_DeferredRenderer::s_geoAlbedoTexLoc = -1;
+DD_DeferredRenderer::GeometryProgram DD_DeferredRenderer::s_geoPrograms[ProgramVariantCount];
 
 GLuint DD_DeferredRenderer::s_lightingProgram = 0;
 GLint DD_DeferredRenderer::s_litPositionTexLoc = -1;
@@ -54,16 +45,22 @@ bool DD_DeferredRenderer::CacheShaders()
         "layout(location = 0) in vec3 aPos;\n"
         "layout(location = 1) in vec3 aNormal;\n"
         "layout(location = 2) in vec2 aTexCoord;\n"
+        "#ifdef INSTANCED\n"
+        "layout(location = 3) in mat4 aInstanceModel;\n"
+        "#define MODEL aInstanceModel\n"
+        "#else\n"
         "uniform mat4 uModel;\n"
+        "#define MODEL uModel\n"
+        "#endif\n"
         "uniform mat4 uView;\n"
         "uniform mat4 uProjection;\n"
         "out vec3 vWorldPos;\n"
         "out vec3 vNormal;\n"
         "out vec2 vTexCoord;\n"
         "void main() {\n"
-        "    vec4 worldPos = uModel * vec4(aPos, 1.0);\n"
+        "    vec4 worldPos = MODEL * vec4(aPos, 1.0);\n"
         "    vWorldPos = worldPos.xyz;\n"
-        "    mat3 normalMatrix = transpose(inverse(mat3(uModel)));\n"
+        "    mat3 normalMatrix = transpose(inverse(mat3(MODEL)));\n"
         "    vNormal = normalize(normalMatrix * aNormal);\n"
         "    vTexCoord = aTexCoord;\n"
         "    gl_Position = uProjection * uView * worldPos;\n"
@@ -171,13 +168,20 @@ bool DD_DeferredRenderer::CacheShaders()
         layout(location = 0) in vec3 aPos;
         layout(location = 1) in vec3 aNormal;
         layout(location = 2) in vec2 aTexCoord;
-        uniform mat4 uModel, uView, uProjection;
+        #ifdef INSTANCED
+        layout(location = 3) in mat4 aInstanceModel;
+        #define MODEL aInstanceModel
+        #else
+        uniform mat4 uModel;
+        #define MODEL uModel
+        #endif
+        uniform mat4 uView, uProjection;
         out vec3 vWorldPos, vNormal;
         out vec2 vTexCoord;
         void main() {
-            vec4 wp = uModel * vec4(aPos, 1.0);
+            vec4 wp = MODEL * vec4(aPos, 1.0);
             vWorldPos = wp.xyz;
-            vNormal = normalize(transpose(inverse(mat3(uModel))) * aNormal);
+            vNormal = normalize(transpose(inverse(mat3(MODEL))) * aNormal);
             vTexCoord = aTexCoord;
             gl_Position = uProjection * uView * wp;
         }
@@ -267,37 +271,45 @@ bool DD_DeferredRenderer::CacheShaders()
     )";
 #endif
 
-    // Compile geometry shader
-    GLuint geoVert = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(geoVert, 1, &geoVertSrc, nullptr);
-    glCompileShader(geoVert);
+    // Compile geometry shader, one program per variant
     GLint success;
-    glGetShaderiv(geoVert, GL_COMPILE_STATUS, &success);
-    if (!success) { char log[512]; glGetShaderInfoLog(geoVert, 512, nullptr, log); printf("Geo vert error: %s\n", log); return false; }
-
     GLuint geoFrag = glCreateShader(GL_FRAGMENT_SHADER);
     glShaderSource(geoFrag, 1, &geoFragSrc, nullptr);
     glCompileShader(geoFrag);
     glGetShaderiv(geoFrag, GL_COMPILE_STATUS, &success);
     if (!success) { char log[512]; glGetShaderInfoLog(geoFrag, 512, nullptr, log); printf("Geo frag error: %s\n", log); return false; }
 
-    s_geometryProgram = glCreateProgram();
-    glAttachShader(s_geometryProgram, geoVert);
-    glAttachShader(s_geometryProgram, geoFrag);
-    glLinkProgram(s_geometryProgram);
-    glDeleteShader(geoVert);
+    for (uint32_t variant = 0; variant < ProgramVariantCount; ++variant)
+    {
+        const std::string source = variant == ProgramInstanced
+            ? GLHelper::WithDefine(geoVertSrc, "INSTANCED") : std::string(geoVertSrc);
+        const char* sourcePtr = source.c_str();
+
+        GLuint geoVert = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(geoVert, 1, &sourcePtr, nullptr);
+        glCompileShader(geoVert);
+        glGetShaderiv(geoVert, GL_COMPILE_STATUS, &success);
+        if (!success) { char log[512]; glGetShaderInfoLog(geoVert, 512, nullptr, log); printf("Geo vert error (variant %u): %s\n", variant, log); glDeleteShader(geoFrag); return false; }
+
+        GeometryProgram& geo = s_geoPrograms[variant];
+        geo.program = glCreateProgram();
+        glAttachShader(geo.program, geoVert);
+        glAttachShader(geo.program, geoFrag);
+        glLinkProgram(geo.program);
+        glDeleteShader(geoVert);
+
+        geo.modelLoc = glGetUniformLocation(geo.program, "uModel");
+        geo.viewLoc = glGetUniformLocation(geo.program, "uView");
+        geo.projLoc = glGetUniformLocation(geo.program, "uProjection");
+        geo.albedoLoc = glGetUniformLocation(geo.program, "uAlbedo");
+        geo.metallicLoc = glGetUniformLocation(geo.program, "uMetallic");
+        geo.roughnessLoc = glGetUniformLocation(geo.program, "uRoughness");
+        geo.aoLoc = glGetUniformLocation(geo.program, "uAO");
+        geo.hasAlbedoTexLoc = glGetUniformLocation(geo.program, "uHasAlbedoTex");
+        geo.albedoTexLoc = glGetUniformLocation(geo.program, "uAlbedoTex");
+    }
     glDeleteShader(geoFrag);
 
-    s_geoModelLoc = glGetUniformLocation(s_geometryProgram, "uModel");
-    s_geoViewLoc = glGetUniformLocation(s_geometryProgram, "uView");
-    s_geoProjLoc = glGetUniformLocation(s_geometryProgram, "uProjection");
-    s_geoAlbedoLoc = glGetUniformLocation(s_geometryProgram, "uAlbedo");
-    s_geoMetallicLoc = glGetUniformLocation(s_geometryProgram, "uMetallic");
-    s_geoRoughnessLoc = glGetUniformLocation(s_geometryProgram, "uRoughness");
-    s_geoAOLoc = glGetUniformLocation(s_geometryProgram, "uAO");
-    s_geoHasAlbedoTexLoc = glGetUniformLocation(s_geometryProgram, "uHasAlbedoTex");
-    s_geoAlbedoTexLoc = glGetUniformLocation(s_geometryProgram, "uAlbedoTex");
-
     // Compile lighting shader
     GLuint litVert = glCreateShader(GL_VERTEX_SHADER);
     glShaderSource(litVert, 1, &litVertSrc, nullptr);
@@ -338,12 +350,12 @@ bool DD_DeferredRenderer::CacheShaders()
 
 void DD_DeferredRenderer::ClearShaders()
 {
-    if (s_geometryProgram) { glDeleteProgram(s_geometryProgram); s_geometryProgram = 0; }
+    for (GeometryProgram& geo : s_geoPrograms) { if (geo.program) glDeleteProgram(geo.program); geo = GeometryProgram(); }
     if (s_lightingProgram) { glDeleteProgram(s_lightingProgram); s_lightingProgram = 0; }
     s_shadersReady = false;
 }
 
-DD_DeferredRenderer::DD_DeferredRenderer() : m_view(1.0f), m_projection(1.0f), m_pointLightCount(0), m_quadVAO(0), m_quadVBO(0) {}
+DD_DeferredRenderer::DD_DeferredRenderer() : m_view(1.0f), m_projection(1.0f), m_pointLightCount(0), m_quadVAO(0), m_quadVBO(0), m_variant(ProgramVariantCount) {}
 DD_DeferredRenderer::~DD_DeferredRenderer() { Shutdown(); }
 
 bool DD_DeferredRenderer::Initialize(int width, int height)
@@ -384,10 +396,8 @@ void DD_DeferredRenderer::BeginGeometryPass(const Matrix4& view, const Matrix4&
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
-    glUseProgram(s_geometryProgram);
-    glUniformMatrix4fv(s_geoViewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(s_geoProjLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    glUniform1i(s_geoAlbedoTexLoc, 0);
+    m_variant = ProgramVariantCount;
+    BindProgram(ProgramDefault);
 }
 
 void DD_DeferredRenderer::RenderActor(DD_Actor* actor)
@@ -398,30 +408,61 @@ void DD_DeferredRenderer::RenderActor(DD_Actor* actor)
     DD_Mesh* mesh = meshComp->GetMesh();
     if (!mesh) return;
 
-    glUniformMatrix4fv(s_geoModelLoc, 1, GL_FALSE, glm::value_ptr(actor->GetModelMatrix()));
+    BindProgram(ProgramDefault);
+    BindMaterial(meshComp->GetMaterial());
+    BindMesh(mesh);
+    Draw(actor->GetModelMatrix(), mesh);
+    UnbindMesh();
+}
+
+void DD_DeferredRenderer::BindProgram(uint32_t program)
+{
+    if (program == m_variant) return;
+    m_variant = program;
+
+    const GeometryProgram& geo = s_geoPrograms[program];
+    glUseProgram(geo.program);
+    glUniformMatrix4fv(geo.viewLoc, 1, GL_FALSE, glm::value_ptr(m_view));
+    glUniformMatrix4fv(geo.projLoc, 1, GL_FALSE, glm::value_ptr(m_projection));
+    glUniform1i(geo.albedoTexLoc, 0);
+}
 
-    DD_Material* mat = meshComp->GetMaterial();
+void DD_DeferredRenderer::BindMaterial(const DD_Material* mat)
+{
+    const GeometryProgram& geo = s_geoPrograms[m_variant];
     if (mat) {
-        glUniform3fv(s_geoAlbedoLoc, 1, glm::value_ptr(mat->GetAlbedo()));
-        glUniform1f(s_geoMetallicLoc, mat->GetMetallic());
-        glUniform1f(s_geoRoughnessLoc, mat->GetRoughness());
-        glUniform1f(s_geoAOLoc, mat->GetAO());
-        if (mat->HasAlbedoTexture()) { glUniform1i(s_geoHasAlbedoTexLoc, 1); glActiveTexture(GL_TEXTURE0); mat->GetAlbedoTexture()->Bind(); }
-        else { glUniform1i(s_geoHasAlbedoTexLoc, 0); }
+        glUniform3fv(geo.albedoLoc, 1, glm::value_ptr(mat->GetAlbedo()));
+        glUniform1f(geo.metallicLoc, mat->GetMetallic());
+        glUniform1f(geo.roughnessLoc, mat->GetRoughness());
+        glUniform1f(geo.aoLoc, mat->GetAO());
+        if (mat->HasAlbedoTexture()) { glUniform1i(geo.hasAlbedoTexLoc, 1); glActiveTexture(GL_TEXTURE0); mat->GetAlbedoTexture()->Bind(); }
+        else { glUniform1i(geo.hasAlbedoTexLoc, 0); }
     } else {
-        glUniform3f(s_geoAlbedoLoc, 0.8f, 0.8f, 0.8f);
-        glUniform1f(s_geoMetallicLoc, 0.0f);
-        glUniform1f(s_geoRoughnessLoc, 0.5f);
-        glUniform1f(s_geoAOLoc, 1.0f);
-        glUniform1i(s_geoHasAlbedoTexLoc, 0);
+        glUniform3f(geo.albedoLoc, 0.8f, 0.8f, 0.8f);
+        glUniform1f(geo.metallicLoc, 0.0f);
+        glUniform1f(geo.roughnessLoc, 0.5f);
+        glUniform1f(geo.aoLoc, 1.0f);
+        glUniform1i(geo.hasAlbedoTexLoc, 0);
     }
+}
+
+void DD_DeferredRenderer::BindMesh(const DD_Mesh* mesh) { glBindVertexArray(mesh->GetVAO()); }
 
-    GLuint vao = mesh->GetVAO();
-    if (vao) glBindVertexArray(vao);
+void DD_DeferredRenderer::Draw(const Matrix4& model, const DD_Mesh* mesh)
+{
+    glUniformMatrix4fv(s_geoPrograms[m_variant].modelLoc, 1, GL_FALSE, glm::value_ptr(model));
     glDrawElements(GL_TRIANGLES, mesh->GetIndexCount(), GL_UNSIGNED_SHORT, 0);
-    if (vao) glBindVertexArray(0);
 }
 
+void DD_DeferredRenderer::DrawInstanced(GLuint instanceBuffer, uint32_t firstInstance, uint32_t count, const DD_Mesh* mesh)
+{
+    GLHelper::BindInstanceModels(instanceBuffer, firstInstance);
+    glDrawElementsInstanced(GL_TRIANGLES, mesh->GetIndexCount(), GL_UNSIGNED_SHORT, 0, count);
+    GLHelper::UnbindInstanceModels();
+}
+
+void DD_DeferredRenderer::UnbindMesh() { glBindVertexArray(0); }
+
 void DD_DeferredRenderer::EndGeometryPass() { m_gBuffer->UnbindGeometryPass(); }
 
 void DD_DeferredRenderer::BeginLightingPass(const Vec3& cameraPos)
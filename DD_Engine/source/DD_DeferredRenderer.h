@@ -1,8 +1,10 @@
 #pragma once
 #include "DD_GLHelper.h"
+#include "DD_RenderQueue.h"
 
 class DD_Actor;
 class DD_Material;
+class DD_Mesh;
 class DD_GBuffer;
 class DD_LightComponent;
 
@@ -45,6 +47,14 @@ public:
     void RenderActor(DD_Actor* actor);
     void EndGeometryPass();
 
+    // State steps for DD_RenderQueue::Submit; valid inside the geometry pass
+    void BindProgram(uint32_t program);
+    void BindMaterial(const DD_Material* material);
+    void BindMesh(const DD_Mesh* mesh);
+    void Draw(const Matrix4& model, const DD_Mesh* mesh);
+    void DrawInstanced(GLuint instanceBuffer, uint32_t firstInstance, uint32_t count, const DD_Mesh* mesh);
+    void UnbindMesh();
+
     // Lighting Pass - reads G-Buffer, outputs final image
     void BeginLightingPass(const Vec3& cameraPos);
     void SetDirectionalLight(const DD_LightComponent* light, GLuint shadowMap, const Matrix4& lightSpaceMatrix);
@@ -74,17 +84,23 @@ private:
     GLuint m_quadVAO;
     GLuint m_quadVBO;
 
-    // Geometry pass shader
-    static GLuint s_geometryProgram;
-    static GLint s_geoModelLoc;
-    static GLint s_geoViewLoc;
-    static GLint s_geoProjLoc;
-    static GLint s_geoAlbedoLoc;
-    static GLint s_geoMetallicLoc;
-    static GLint s_geoRoughnessLoc;
-    static GLint s_geoAOLoc;
-    static GLint s_geoHasAlbedoTexLoc;
-    static GLint s_geoAlbedoTexLoc;
+    uint32_t m_variant;  // Bound ProgramVariant, ProgramVariantCount when none
+
+    // Geometry pass shader, one program per ProgramVariant
+    struct GeometryProgram
+    {
+        GLuint program = 0;
+        GLint modelLoc = -1;  // -1 in the instanced variant
+        GLint viewLoc = -1;
+        GLint projLoc = -1;
+        GLint albedoLoc = -1;
+        GLint metallicLoc = -1;
+        GLint roughnessLoc = -1;
+        GLint aoLoc = -1;
+        GLint hasAlbedoTexLoc = -1;
+        GLint albedoTexLoc = -1;
+    };
+    static GeometryProgram s_geoPrograms[ProgramVariantCount];
 
     // Lighting pass shader
     static GLuint s_lightingProgram;
@@ -0,0 +1,344 @@
+#include "DD_DynamicAABBTree.h"
+#include <algorithm>
+
+// Fat AABBs are extended by this multiple of the displacement in the direction of motion
+static constexpr float kDisplacementMultiplier = 2.0f;
+
+DD_DynamicAABBTree::DD_DynamicAABBTree(float margin)
+    : m_root(NullNode)
+    , m_freeList(NullNode)
+    , m_leafCount(0)
+    , m_margin(margin)
+{
+}
+
+DD_DynamicAABBTree::~DD_DynamicAABBTree()
+{
+}
+
+std::vector<int>& DD_DynamicAABBTree::TraversalStack()
+{
+    static thread_local std::vector<int> stack;
+    return stack;
+}
+
+int DD_DynamicAABBTree::AllocateNode()
+{
+    if (m_freeList == NullNode)
+    {
+        m_nodes.emplace_back();
+        return static_cast<int>(m_nodes.size()) - 1;
+    }
+
+    int nodeId = m_freeList;
+    m_freeList = m_nodes[nodeId].parent;
+    m_nodes[nodeId] = Node();
+    return nodeId;
+}
+
+void DD_DynamicAABBTree::FreeNode(int nodeId)
+{
+    Node& node = m_nodes[nodeId];
+    node.parent = m_freeList;
+    node.userData = nullptr;
+    node.height = -1;
+    m_freeList = nodeId;
+}
+
+int DD_DynamicAABBTree::CreateProxy(const AABB& aabb, void* userData)
+{
+    int proxyId = AllocateNode();
+    Node& node = m_nodes[proxyId];
+    const Vec3 margin(m_margin);
+    node.bounds.lower = aabb.center - aabb.halfExtents - margin;
+    node.bounds.upper = aabb.center + aabb.halfExtents + margin;
+    node.userData = userData;
+    node.height = 0;
+
+    InsertLeaf(proxyId);
+    ++m_leafCount;
+    return proxyId;
+}
+
+void DD_DynamicAABBTree::DestroyProxy(int proxyId)
+{
+    if (proxyId < 0 || proxyId >= static_cast<int>(m_nodes.size())) return;
+    if (!m_nodes[proxyId].IsLeaf() || m_nodes[proxyId].height != 0) return;
+
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+    --m_leafCount;
+}
+
+bool DD_DynamicAABBTree::MoveProxy(int proxyId, const AABB& aabb, const Vec3& displacement)
+{
+    TreeBounds tight = TreeBounds::FromAABB(aabb);
+    if (m_nodes[proxyId].bounds.Contains(tight)) return false;
+
+    RemoveLeaf(proxyId);
+
+    const Vec3 margin(m_margin);
+    TreeBounds fat = { tight.lower - margin, tight.upper + margin };
+
+    // Predict motion so a steadily moving proxy is not reinserted every frame
+    Vec3 d = displacement * kDisplacementMultiplier;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (d[axis] < 0.0f) fat.lower[axis] += d[axis];
+        else fat.upper[axis] += d[axis];
+    }
+
+    m_nodes[proxyId].bounds = fat;
+    InsertLeaf(proxyId);
+    return true;
+}
+
+void DD_DynamicAABBTree::InsertLeaf(int leaf)
+{
+    if (m_root == NullNode)
+    {
+        m_root = leaf;
+        m_nodes[leaf].parent = NullNode;
+        return;
+    }
+
+    // Find the best sibling using the surface area heuristic
+    const TreeBounds leafBounds = m_nodes[leaf].bounds;
+    int index = m_root;
+    while (!m_nodes[index].IsLeaf())
+    {
+        const Node& node = m_nodes[index];
+        int child1 = node.child1;
+        int child2 = node.child2;
+
+        float area = node.bounds.Area();
+        float combinedArea = TreeBounds::Combine(node.bounds, leafBounds).Area();
+
+        // Cost of creating a new parent for this node and the new leaf
+        float cost = 2.0f * combinedArea;
+
+        // Minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int child)
+        {
+            const Node& c = m_nodes[child];
+            float combined = TreeBounds::Combine(leafBounds, c.bounds).Area();
+            if (c.IsLeaf()) return combined + inheritanceCost;
+            return (combined - c.bounds.Area()) + inheritanceCost;
+        };
+
+        float cost1 = descendCost(child1);
+        float cost2 = descendCost(child2);
+
+        if (cost < cost1 && cost < cost2) break;
+
+        index = (cost1 < cost2) ? child1 : child2;
+    }
+
+    int sibling = index;
+
+    // Create a new parent (AllocateNode may reallocate m_nodes)
+    int oldParent = m_nodes[sibling].parent;
+    int newParent = AllocateNode();
+    {
+        Node& parentNode = m_nodes[newParent];
+        parentNode.parent = oldParent;
+        parentNode.userData = nullptr;
+        parentNode.bounds = TreeBounds::Combine(leafBounds, m_nodes[sibling].bounds);
+        parentNode.height = m_nodes[sibling].height + 1;
+        parentNode.child1 = sibling;
+        parentNode.child2 = leaf;
+    }
+
+    if (oldParent != NullNode)
+    {
+        if (m_nodes[oldParent].child1 == sibling) m_nodes[oldParent].child1 = newParent;
+        else m_nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        m_root = newParent;
+    }
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    // Walk back up, rebalancing and refitting
+    index = m_nodes[leaf].parent;
+    while (index != NullNode)
+    {
+        index = Balance(index);
+
+        Node& node = m_nodes[index];
+        const Node& c1 = m_nodes[node.child1];
+        const Node& c2 = m_nodes[node.child2];
+        node.height = 1 + std::max(c1.height, c2.height);
+        node.bounds = TreeBounds::Combine(c1.bounds, c2.bounds);
+
+        index = node.parent;
+    }
+}
+
+void DD_DynamicAABBTree::RemoveLeaf(int leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = NullNode;
+        return;
+    }
+
+    int parent = m_nodes[leaf].parent;
+    int grandParent = m_nodes[parent].parent;
+    int sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    if (grandParent != NullNode)
+    {
+        // Replace the parent with the sibling
+        if (m_nodes[grandParent].child1 == parent) m_nodes[grandParent].child1 = sibling;
+        else m_nodes[grandParent].child2 = sibling;
+        m_nodes[sibling].parent = grandParent;
+        FreeNode(parent);
+
+        int index = grandParent;
+        while (index != NullNode)
+        {
+            index = Balance(index);
+
+            Node& node = m_nodes[index];
+            const Node& c1 = m_nodes[node.child1];
+            const Node& c2 = m_nodes[node.child2];
+            node.bounds = TreeBounds::Combine(c1.bounds, c2.bounds);
+            node.height = 1 + std::max(c1.height, c2.height);
+
+            index = node.parent;
+        }
+    }
+    else
+    {
+        m_root = sibling;
+        m_nodes[sibling].parent = NullNode;
+        FreeNode(parent);
+    }
+}
+
+// Performs a left or right rotation if node A is imbalanced. Returns the new subtree root.
+int DD_DynamicAABBTree::Balance(int iA)
+{
+    Node& A = m_nodes[iA];
+    if (A.IsLeaf() || A.height < 2) return iA;
+
+    int iB = A.child1;
+    int iC = A.child2;
+    Node& B = m_nodes[iB];
+    Node& C = m_nodes[iC];
+
+    int balance = C.height - B.height;
+
+    // Rotate C up
+    if (balance > 1)
+    {
+        int iF = C.child1;
+        int iG = C.child2;
+        Node& F = m_nodes[iF];
+        Node& G = m_nodes[iG];
+
+        C.child1 = iA;
+        C.parent = A.parent;
+        A.parent = iC;
+
+        if (C.parent != NullNode)
+        {
+            if (m_nodes[C.parent].child1 == iA) m_nodes[C.parent].child1 = iC;
+            else m_nodes[C.parent].child2 = iC;
+        }
+        else
+        {
+            m_root = iC;
+        }
+
+        if (F.height > G.height)
+        {
+            C.child2 = iF;
+            A.child2 = iG;
+            G.parent = iA;
+            A.bounds = TreeBounds::Combine(B.bounds, G.bounds);
+            C.bounds = TreeBounds::Combine(A.bounds, F.bounds);
+            A.height = 1 + std::max(B.height, G.height);
+            C.height = 1 + std::max(A.height, F.height);
+        }
+        else
+        {
+            C.child2 = iG;
+            A.child2 = iF;
+            F.parent = iA;
+            A.bounds = TreeBounds::Combine(B.bounds, F.bounds);
+            C.bounds = TreeBounds::Combine(A.bounds, G.bounds);
+            A.height = 1 + std::max(B.height, F.height);
+            C.height = 1 + std::max(A.height, G.height);
+        }
+        return iC;
+    }
+
+    // Rotate B up
+    if (balance < -1)
+    {
+        int iD = B.child1;
+        int iE = B.child2;
+        Node& D = m_nodes[iD];
+        Node& E = m_nodes[iE];
+
+        B.child1 = iA;
+        B.parent = A.parent;
+        A.parent = iB;
+
+        if (B.parent != NullNode)
+        {
+            if (m_nodes[B.parent].child1 == iA) m_nodes[B.parent].child1 = iB;
+            else m_nodes[B.parent].child2 = iB;
+        }
+        else
+        {
+            m_root = iB;
+        }
+
+        if (D.height > E.height)
+        {
+            B.child2 = iD;
+            A.child1 = iE;
+            E.parent = iA;
+            A.bounds = TreeBounds::Combine(C.bounds, E.bounds);
+            B.bounds = TreeBounds::Combine(A.bounds, D.bounds);
+            A.height = 1 + std::max(C.height, E.height);
+            B.height = 1 + std::max(A.height, D.height);
+        }
+        else
+        {
+            B.child2 = iE;
+            A.child1 = iD;
+            D.parent = iA;
+            A.bounds = TreeBounds::Combine(C.bounds, D.bounds);
+            B.bounds = TreeBounds::Combine(A.bounds, E.bounds);
+            A.height = 1 + std::max(C.height, D.height);
+            B.height = 1 + std::max(A.height, E.height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+float DD_DynamicAABBTree::GetAreaRatio() const
+{
+    if (m_root == NullNode) return 0.0f;
+
+    float rootArea = m_nodes[m_root].bounds.Area();
+    if (rootArea < DD_SMALL_NUMBER) return 0.0f;
+
+    float totalArea = 0.0f;
+    for (const Node& node : m_nodes)
+    {
+        if (node.height < 0) continue;
+        totalArea += node.bounds.Area();
+    }
+    return totalArea / rootArea;
+}
@@ -0,0 +1,269 @@
+#pragma once
+#include "framework.h"
+#include "DD_CollisionUtils.h"
+#include <cmath>
+#include <vector>
+
+// Min/max box used inside the tree
+struct TreeBounds
+{
+    Vec3 lower;
+    Vec3 upper;
+
+    static TreeBounds FromAABB(const AABB& aabb)
+    {
+        return { aabb.center - aabb.halfExtents, aabb.center + aabb.halfExtents };
+    }
+
+    static TreeBounds Combine(const TreeBounds& a, const TreeBounds& b)
+    {
+        return { glm::min(a.lower, b.lower), glm::max(a.upper, b.upper) };
+    }
+
+    // Surface area, used as the SAH cost
+    float Area() const
+    {
+        Vec3 d = upper - lower;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    bool Contains(const TreeBounds& other) const
+    {
+        return lower.x <= other.lower.x && lower.y <= other.lower.y && lower.z <= other.lower.z
+            && other.upper.x <= upper.x && other.upper.y <= upper.y && other.upper.z <= upper.z;
+    }
+
+    bool Overlaps(const TreeBounds& other) const
+    {
+        return lower.x < other.upper.x && other.lower.x < upper.x
+            && lower.y < other.upper.y && other.lower.y < upper.y
+            && lower.z < other.upper.z && other.lower.z < upper.z;
+    }
+};
+
+// Dynamic bounding volume hierarchy (after Box2D's b2DynamicTree).
+// Leaves store fat AABBs so small motions do not touch the tree. Insertion picks the
+// sibling with the surface area heuristic and AVL rotations keep the tree balanced.
+class DD_DynamicAABBTree
+{
+public:
+    static constexpr int NullNode = -1;
+
+    explicit DD_DynamicAABBTree(float margin = 0.1f);
+    ~DD_DynamicAABBTree();
+
+    // Proxy ids are leaf node indices
+    int CreateProxy(const AABB& aabb, void* userData);
+    void DestroyProxy(int proxyId);
+
+    // Reinserts the leaf only if aabb left the fat AABB. displacement extends the fat
+    // AABB in the direction of motion. Returns true if the leaf was reinserted.
+    bool MoveProxy(int proxyId, const AABB& aabb, const Vec3& displacement);
+
+    void* GetUserData(int proxyId) const { return m_nodes[proxyId].userData; }
+    const TreeBounds& GetFatBounds(int proxyId) const { return m_nodes[proxyId].bounds; }
+
+    // callback(int proxyId) -> bool, return false to stop
+    template<typename T>
+    void Query(const TreeBounds& bounds, T&& callback) const;
+
+    // callback(int proxyId, float maxT) -> float, returns the new clip distance (0 stops)
+    template<typename T>
+    void RayCast(const Vec3& origin, const Vec3& dir, float maxT, T&& callback) const;
+
+    // Packet traversal: a node is visited while any ray in the packet touches it.
+    // callback(int proxyId, int laneMask) receives the rays that reach each leaf.
+    template<typename T>
+    void RayCastPacket(const RayPacket& packet, T&& callback) const;
+
+    // Tree-vs-tree self traversal: callback(int proxyA, int proxyB) for every pair of
+    // leaves whose fat AABBs overlap
+    template<typename T>
+    void QueryPairs(T&& callback) const;
+
+    int GetHeight() const { return m_root == NullNode ? 0 : m_nodes[m_root].height; }
+    int GetProxyCount() const { return m_leafCount; }
+    float GetMargin() const { return m_margin; }
+    void SetMargin(float margin) { m_margin = margin; }
+
+    // Sum of node areas over root area, a quality metric for the tree
+    float GetAreaRatio() const;
+
+private:
+    struct Node
+    {
+        TreeBounds bounds;
+        void* userData = nullptr;
+        int parent = NullNode;  // Next free node when in the free list
+        int child1 = NullNode;
+        int child2 = NullNode;
+        int height = -1;        // Leaf = 0, free = -1
+
+        bool IsLeaf() const { return child1 == NullNode; }
+    };
+
+    int AllocateNode();
+    void FreeNode(int nodeId);
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+    int Balance(int iA);
+
+    // Per-thread scratch stack for traversals, so const queries can run concurrently
+    static std::vector<int>& TraversalStack();
+
+private:
+    std::vector<Node> m_nodes;
+    int m_root;
+    int m_freeList;
+    int m_leafCount;
+    float m_margin;
+};
+
+template<typename T>
+void DD_DynamicAABBTree::Query(const TreeBounds& bounds, T&& callback) const
+{
+    if (m_root == NullNode) return;
+
+    std::vector<int>& stack = TraversalStack();
+    stack.clear();
+    stack.push_back(m_root);
+    while (!stack.empty())
+    {
+        int nodeId = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_nodes[nodeId];
+        if (!node.bounds.Overlaps(bounds)) continue;
+
+        if (node.IsLeaf())
+        {
+            if (!callback(nodeId)) return;
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+template<typename T>
+void DD_DynamicAABBTree::RayCast(const Vec3& origin, const Vec3& dir, float maxT, T&& callback) const
+{
+    if (m_root == NullNode) return;
+
+    Vec3 invDir;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        invDir[axis] = fabsf(dir[axis]) > DD_SMALL_NUMBER ? 1.0f / dir[axis] : (dir[axis] < 0.0f ? -1e30f : 1e30f);
+    }
+
+    std::vector<int>& stack = TraversalStack();
+    stack.clear();
+    stack.push_back(m_root);
+    while (!stack.empty())
+    {
+        int nodeId = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_nodes[nodeId];
+
+        // Slab test against the node bounds
+        float tMin = 0.0f, tMax = maxT;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float t1 = (node.bounds.lower[axis] - origin[axis]) * invDir[axis];
+            float t2 = (node.bounds.upper[axis] - origin[axis]) * invDir[axis];
+            if (t1 > t2) { float t = t1; t1 = t2; t2 = t; }
+            tMin = t1 > tMin ? t1 : tMin;
+            tMax = t2 < tMax ? t2 : tMax;
+        }
+        if (tMin > tMax) continue;
+
+        if (node.IsLeaf())
+        {
+            maxT = callback(nodeId, maxT);
+            if (maxT <= 0.0f) return;
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+template<typename T>
+void DD_DynamicAABBTree::RayCastPacket(const RayPacket& packet, T&& callback) const
+{
+    if (m_root == NullNode || packet.count == 0) return;
+
+    std::vector<int>& stack = TraversalStack();
+    stack.clear();
+    stack.push_back(m_root);
+    while (!stack.empty())
+    {
+        int nodeId = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_nodes[nodeId];
+        int laneMask = CollisionUtils::TestRayPacketVsBox(packet, node.bounds.lower, node.bounds.upper);
+        if (laneMask == 0) continue;
+
+        if (node.IsLeaf())
+        {
+            callback(nodeId, laneMask);
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+template<typename T>
+void DD_DynamicAABBTree::QueryPairs(T&& callback) const
+{
+    if (m_root == NullNode) return;
+
+    // Stack of node pairs; a pair (n, n) stands for "all pairs inside subtree n"
+    std::vector<int>& stack = TraversalStack();
+    stack.clear();
+    stack.push_back(m_root);
+    stack.push_back(m_root);
+    while (!stack.empty())
+    {
+        int b = stack.back(); stack.pop_back();
+        int a = stack.back(); stack.pop_back();
+        const Node& nodeA = m_nodes[a];
+        const Node& nodeB = m_nodes[b];
+
+        if (a == b)
+        {
+            if (nodeA.IsLeaf()) continue;
+            stack.push_back(nodeA.child1); stack.push_back(nodeA.child1);
+            stack.push_back(nodeA.child2); stack.push_back(nodeA.child2);
+            stack.push_back(nodeA.child1); stack.push_back(nodeA.child2);
+            continue;
+        }
+
+        if (!nodeA.bounds.Overlaps(nodeB.bounds)) continue;
+
+        if (nodeA.IsLeaf() && nodeB.IsLeaf())
+        {
+            callback(a, b);
+        }
+        else if (nodeB.IsLeaf() || (!nodeA.IsLeaf() && nodeA.bounds.Area() >= nodeB.bounds.Area()))
+        {
+            // Descend into the larger internal node
+            stack.push_back(nodeA.child1); stack.push_back(b);
+            stack.push_back(nodeA.child2); stack.push_back(b);
+        }
+        else
+        {
+            stack.push_back(a); stack.push_back(nodeB.child1);
+            stack.push_back(a); stack.push_back(nodeB.child2);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include "DD_FrameArena.h"
+
+DD_FrameArena::DD_FrameArena(size_t blockSize)
+    : m_blockSize(blockSize)
+    , m_current(0)
+    , m_offset(0)
+    , m_bytesUsed(0)
+{
+}
+
+void* DD_FrameArena::Allocate(size_t size, size_t align)
+{
+    for (;;)
+    {
+        if (m_current < m_blocks.size())
+        {
+            Block& block = m_blocks[m_current];
+            const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+            const uintptr_t aligned = (base + m_offset + align - 1) & ~static_cast<uintptr_t>(align - 1);
+            const size_t end = static_cast<size_t>(aligned - base) + size;
+            if (end <= block.size)
+            {
+                m_bytesUsed += end - m_offset;
+                m_offset = end;
+                return reinterpret_cast<void*>(aligned);
+            }
+
+            // Move on to the next retained block; the tail of this one is wasted
+            if (m_current + 1 < m_blocks.size())
+            {
+                ++m_current;
+                m_offset = 0;
+                continue;
+            }
+        }
+
+        // Out of blocks: grow, with room for an oversized request
+        Block block;
+        block.size = size + align > m_blockSize ? size + align : m_blockSize;
+        block.data.reset(new uint8_t[block.size]);
+        m_blocks.push_back(std::move(block));
+        m_current = m_blocks.size() - 1;
+        m_offset = 0;
+    }
+}
+
+void DD_FrameArena::Reset()
+{
+    m_current = 0;
+    m_offset = 0;
+    m_bytesUsed = 0;
+}
+
+size_t DD_FrameArena::GetCapacity() const
+{
+    size_t capacity = 0;
+    for (const Block& block : m_blocks) capacity += block.size;
+    return capacity;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump allocator for data that lives until the end of a frame.
+// Reset rewinds to the first block but keeps every block, so once the arena has grown to
+// a frame's peak usage, allocating from it never touches the heap again.
+// Objects are never destroyed individually and must be trivially destructible.
+class DD_FrameArena
+{
+public:
+    explicit DD_FrameArena(size_t blockSize = 16 * 1024);
+
+    DD_FrameArena(const DD_FrameArena&) = delete;
+    DD_FrameArena& operator=(const DD_FrameArena&) = delete;
+
+    // align must be a power of two
+    void* Allocate(size_t size, size_t align);
+
+    template<typename T, typename... Args>
+    T* New(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "frame arena objects are never destroyed");
+        return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Invalidates everything allocated since the last reset
+    void Reset();
+
+    size_t GetBytesUsed() const { return m_bytesUsed; }
+    size_t GetCapacity() const;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+    };
+    std::vector<Block> m_blocks;
+    size_t m_blockSize;
+    size_t m_current;  // Block being filled
+    size_t m_offset;   // Next free byte in it
+    size_t m_bytesUsed;
+};
@@ -0,0 +1,131 @@
+#include "DD_FrustumCuller.h"
+#include "DD_SIMD.h"
+#include <algorithm>
+
+using Simd::BatchFloat;
+using Simd::kBatchLanes;
+using Simd::BatchLoad;
+using Simd::BatchSplat;
+
+Frustum Frustum::FromMatrix(const Matrix4& m)
+{
+    // Gribb-Hartmann: each clip plane is the last row plus or minus another row.
+    // glm is column-major, so row i is (m[0][i], m[1][i], m[2][i], m[3][i]).
+    const Vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const Vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const Vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const Vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum frustum;
+    frustum.planes[0] = row3 + row0;  // Left
+    frustum.planes[1] = row3 - row0;  // Right
+    frustum.planes[2] = row3 + row1;  // Bottom
+    frustum.planes[3] = row3 - row1;  // Top
+    frustum.planes[4] = row3 + row2;  // Near
+    frustum.planes[5] = row3 - row2;  // Far
+
+    for (Vec4& plane : frustum.planes)
+    {
+        const float length = glm::length(Vec3(plane));
+        if (length > 0.0f) plane = plane * (1.0f / length);
+    }
+    return frustum;
+}
+
+void DD_FrustumCuller::Clear()
+{
+    for (std::vector<float>& column : m_columns) column.clear();
+    m_count = 0;
+}
+
+uint32_t DD_FrustumCuller::Add(const Matrix4& model, const Vec3& localCenter, const Vec3& localHalfExtents)
+{
+    const uint32_t index = m_count++;
+    if (index >= m_columns[0].size())
+    {
+        // Padding lanes are tested and masked off
+        for (std::vector<float>& column : m_columns) column.resize(column.size() + kBatchLanes, 0.0f);
+    }
+
+    const Vec3 center = Vec3(model * Vec4(localCenter, 1.0f));
+    const Vec3 axisX = Vec3(model[0]), axisY = Vec3(model[1]), axisZ = Vec3(model[2]);
+
+    // Extents of the transformed box along the world axes
+    const Vec3 half = glm::abs(axisX) * localHalfExtents.x
+                    + glm::abs(axisY) * localHalfExtents.y
+                    + glm::abs(axisZ) * localHalfExtents.z;
+
+    // The local box's sphere under the largest axis scale
+    const float maxScale = std::max(glm::length(axisX), std::max(glm::length(axisY), glm::length(axisZ)));
+    const float radius = glm::length(localHalfExtents) * maxScale;
+
+    m_columns[CenterX][index] = center.x;
+    m_columns[CenterY][index] = center.y;
+    m_columns[CenterZ][index] = center.z;
+    m_columns[Radius][index] = radius;
+    m_columns[HalfX][index] = half.x;
+    m_columns[HalfY][index] = half.y;
+    m_columns[HalfZ][index] = half.z;
+    return index;
+}
+
+uint32_t DD_FrustumCuller::Cull(const Frustum& frustum, std::vector<uint64_t>& visible) const
+{
+    visible.assign((m_count + 63) / 64, 0);
+
+    BatchFloat nx[6], ny[6], nz[6], nw[6], ax[6], ay[6], az[6];
+    for (int p = 0; p < 6; ++p)
+    {
+        const Vec4& plane = frustum.planes[p];
+        nx[p] = BatchSplat(plane.x);
+        ny[p] = BatchSplat(plane.y);
+        nz[p] = BatchSplat(plane.z);
+        nw[p] = BatchSplat(plane.w);
+        ax[p] = BatchSplat(std::abs(plane.x));
+        ay[p] = BatchSplat(std::abs(plane.y));
+        az[p] = BatchSplat(std::abs(plane.z));
+    }
+    const BatchFloat zero = BatchSplat(0.0f);
+
+    uint32_t visibleCount = 0;
+    for (uint32_t first = 0; first < m_count; first += kBatchLanes)
+    {
+        const BatchFloat cx = BatchLoad(m_columns[CenterX].data() + first);
+        const BatchFloat cy = BatchLoad(m_columns[CenterY].data() + first);
+        const BatchFloat cz = BatchLoad(m_columns[CenterZ].data() + first);
+        const BatchFloat negRadius = Simd::Sub(zero, BatchLoad(m_columns[Radius].data() + first));
+
+        // Signed distance of each center to each plane, shared by both tests
+        BatchFloat dist[6];
+        auto inside = Simd::CmpGe(zero, zero);
+        for (int p = 0; p < 6; ++p)
+        {
+            dist[p] = Simd::MulAdd(nx[p], cx, Simd::MulAdd(ny[p], cy, Simd::MulAdd(nz[p], cz, nw[p])));
+            inside = Simd::MaskAnd(inside, Simd::CmpGe(dist[p], negRadius));
+        }
+        uint32_t laneMask = static_cast<uint32_t>(Simd::MoveMask(inside));
+
+        if (laneMask != 0)
+        {
+            // Box test: the box reaches dot(|n|, half) past its center toward the plane
+            const BatchFloat hx = BatchLoad(m_columns[HalfX].data() + first);
+            const BatchFloat hy = BatchLoad(m_columns[HalfY].data() + first);
+            const BatchFloat hz = BatchLoad(m_columns[HalfZ].data() + first);
+            for (int p = 0; p < 6; ++p)
+            {
+                const BatchFloat reach = Simd::MulAdd(ax[p], hx, Simd::MulAdd(ay[p], hy, Simd::Mul(az[p], hz)));
+                inside = Simd::MaskAnd(inside, Simd::CmpGe(Simd::Add(dist[p], reach), zero));
+            }
+            laneMask = static_cast<uint32_t>(Simd::MoveMask(inside));
+        }
+
+        const uint32_t lanes = std::min<uint32_t>(kBatchLanes, m_count - first);
+        laneMask &= (1u << lanes) - 1u;
+        if (laneMask == 0) continue;
+
+        // kBatchLanes divides 64, so a batch never straddles two words
+        visible[first >> 6] |= static_cast<uint64_t>(laneMask) << (first & 63);
+        for (uint32_t bits = laneMask; bits; bits &= bits - 1) ++visibleCount;
+    }
+    return visibleCount;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "DD_GLHelper.h"
+#include <cstdint>
+#include <vector>
+
+// Six planes facing into a view volume: xyz is the unit normal, w the offset, so a point
+// p is inside a plane when dot(xyz, p) + w >= 0
+struct Frustum
+{
+    Vec4 planes[6];
+
+    // Planes of the clip volume of an OpenGL view-projection (or light-space) matrix
+    static Frustum FromMatrix(const Matrix4& viewProjection);
+};
+
+// World-space bounds of the frame's mesh instances, tested against frustums.
+// Each instance gets an enclosing sphere and a world AABB, stored in structure-of-arrays
+// columns padded to whole SIMD batches. A batch is rejected with the sphere test first;
+// survivors are refined with the AABB test, which is tighter for boxes near plane edges.
+class DD_FrustumCuller
+{
+public:
+    void Clear();
+
+    // Bounds of the box localCenter +- localHalfExtents under model. Returns its index.
+    uint32_t Add(const Matrix4& model, const Vec3& localCenter, const Vec3& localHalfExtents);
+    uint32_t GetCount() const { return m_count; }
+
+    // Sets one bit per instance, in Add order, when its bounds may intersect the frustum.
+    // Returns the number of bits set.
+    uint32_t Cull(const Frustum& frustum, std::vector<uint64_t>& visible) const;
+
+    static bool IsVisible(const std::vector<uint64_t>& visible, uint32_t index)
+    {
+        return ((visible[index >> 6] >> (index & 63)) & 1) != 0;
+    }
+
+private:
+    enum Column { CenterX, CenterY, CenterZ, Radius, HalfX, HalfY, HalfZ, ColumnCount };
+
+    std::vector<float> m_columns[ColumnCount];
+    uint32_t m_count = 0;
+};
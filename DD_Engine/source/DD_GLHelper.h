@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 
 using Vec2 = glm::vec2;
 using Vec3 = glm::vec3;
@@ -94,6 +95,46 @@ namespace GLHelper
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     }
 
+    // Per-instance model matrix, one column per attribute location
+    constexpr GLuint kInstanceModelLocation = 3;
+
+    // Feeds instanced vertex shaders their model matrices from buffer, starting at
+    // firstInstance. The state lands in the bound vertex array; unbind before drawing
+    // that array without instances.
+    inline void BindInstanceModels(GLuint buffer, size_t firstInstance)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        const size_t base = firstInstance * sizeof(Matrix4);
+        for (GLuint i = 0; i < 4; ++i)
+        {
+            const GLuint location = kInstanceModelLocation + i;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix4), (void*)(base + i * sizeof(Vec4)));
+            glVertexAttribDivisor(location, 1);
+        }
+    }
+
+    inline void UnbindInstanceModels()
+    {
+        for (GLuint i = 0; i < 4; ++i)
+        {
+            glVertexAttribDivisor(kInstanceModelLocation + i, 0);
+            glDisableVertexAttribArray(kInstanceModelLocation + i);
+        }
+    }
+
+    // Copy of a shader source with "#define name" after its #version line, for
+    // compiling variants of one source
+    inline std::string WithDefine(const char* source, const char* name)
+    {
+        std::string result(source);
+        const size_t version = result.find("#version");
+        const size_t lineEnd = version == std::string::npos ? std::string::npos : result.find('\n', version);
+        const size_t at = lineEnd == std::string::npos ? 0 : lineEnd + 1;
+        result.insert(at, std::string("#define ") + name + "\n");
+        return result;
+    }
+
     // Check if extension is available
     inline bool HasExtension(const char* name)
     {
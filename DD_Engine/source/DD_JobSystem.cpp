@@ -0,0 +1,251 @@
+#include "DD_JobSystem.h"
+
+constexpr int64_t DD_JobSystem::Deque::Capacity;
+constexpr uint32_t DD_JobSystem::Worker::RingSize;
+
+namespace
+{
+    // Index into m_workers of the calling thread, -1 for threads the system does not own
+    thread_local int t_workerIndex = -1;
+}
+
+// Deque ------------------------------------------------------------------------------------
+
+DD_JobSystem::Deque::Deque()
+    : m_top(0)
+    , m_bottom(0)
+{
+    for (auto& item : m_items) item.store(nullptr, std::memory_order_relaxed);
+}
+
+bool DD_JobSystem::Deque::Push(Job* job)
+{
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const int64_t t = m_top.load(std::memory_order_acquire);
+    if (b - t >= Capacity) return false;
+
+    // Release publishes the job's fields to thieves that acquire m_bottom
+    m_items[b & (Capacity - 1)].store(job, std::memory_order_relaxed);
+    m_bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+DD_JobSystem::Job* DD_JobSystem::Deque::Pop()
+{
+    const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = m_top.load(std::memory_order_relaxed);
+
+    if (t > b)
+    {
+        // Empty
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = m_items[b & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (t == b)
+    {
+        // Last job: race the thieves for it
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) job = nullptr;
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+DD_JobSystem::Job* DD_JobSystem::Deque::Steal()
+{
+    int64_t t = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = m_bottom.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+
+    Job* job = m_items[t & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+    return job;
+}
+
+// DD_JobSystem -----------------------------------------------------------------------------
+
+DD_JobSystem::DD_JobSystem()
+    : m_queuedJobs(0)
+    , m_sleepingWorkers(0)
+    , m_quit(false)
+    , m_jobsExecuted(0)
+    , m_jobsStolen(0)
+{
+}
+
+DD_JobSystem::~DD_JobSystem()
+{
+    Finalize();
+}
+
+int DD_JobSystem::GetDefaultWorkerCount()
+{
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    return hardware > 1 ? hardware - 1 : 0;
+}
+
+void DD_JobSystem::Initialize()
+{
+    if (!m_workers.empty()) return;
+
+    int workerCount = GetDefaultWorkerCount();
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    workerCount = 0;
+#endif
+
+    m_quit.store(false);
+    for (int i = 0; i <= workerCount; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->random = 0x9E3779B9u * static_cast<uint32_t>(i + 1);
+    }
+
+    t_workerIndex = 0;
+    for (int i = 1; i <= workerCount; ++i)
+    {
+        m_threads.emplace_back(&DD_JobSystem::WorkerMain, this, i);
+    }
+    printf("DD_JobSystem: %d worker threads\n", workerCount);
+}
+
+void DD_JobSystem::Tick(float deltaTime)
+{
+}
+
+void DD_JobSystem::Finalize()
+{
+    if (m_workers.empty()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_quit.store(true);
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads) thread.join();
+    m_threads.clear();
+
+    // Anything still queued was never waited on
+    m_workers.clear();
+    m_queuedJobs.store(0);
+    t_workerIndex = -1;
+}
+
+int DD_JobSystem::ChunkSize(int count, int minChunk) const
+{
+    if (m_threads.empty()) return count;
+
+    // A few chunks per thread so stealing can even out uneven chunks
+    const int target = GetThreadCount() * 4;
+    int chunk = (count + target - 1) / target;
+    if (chunk < minChunk) chunk = minChunk;
+    return chunk < 1 ? 1 : chunk;
+}
+
+void DD_JobSystem::Run(DD_JobFn fn, void* context, DD_JobCounter* counter)
+{
+    Submit(fn, context, 0, 0, counter);
+}
+
+void DD_JobSystem::Submit(DD_JobFn fn, void* context, int begin, int end, DD_JobCounter* counter)
+{
+    const int self = t_workerIndex;
+    if (self < 0 || m_threads.empty())
+    {
+        fn(context, begin, end);
+        return;
+    }
+
+    Worker& worker = *m_workers[self];
+    Job* job = &worker.ring[worker.ringNext++ & (Worker::RingSize - 1)];
+    job->fn = fn;
+    job->context = context;
+    job->begin = begin;
+    job->end = end;
+    job->counter = counter;
+
+    if (counter) counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    if (!worker.deque.Push(job))
+    {
+        Execute(*job);
+        return;
+    }
+
+    // Pairs with the sleeping count and queue check in WorkerMain, so a worker either
+    // sees the job or is woken for it
+    m_queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+    if (m_sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+    {
+        { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+        m_wake.notify_one();
+    }
+}
+
+void DD_JobSystem::Execute(const Job& job)
+{
+    job.fn(job.context, job.begin, job.end);
+    m_jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+    if (job.counter) job.counter->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool DD_JobSystem::TryRunOne(int self)
+{
+    Job* job = self >= 0 ? m_workers[self]->deque.Pop() : nullptr;
+    bool stolen = false;
+
+    if (!job)
+    {
+        const int count = static_cast<int>(m_workers.size());
+        uint32_t start = 0;
+        if (self >= 0)
+        {
+            // xorshift, so thieves do not all hammer the same victim
+            uint32_t& r = m_workers[self]->random;
+            r ^= r << 13; r ^= r >> 17; r ^= r << 5;
+            start = r;
+        }
+        for (int i = 0; i < count && !job; ++i)
+        {
+            const int victim = static_cast<int>((start + i) % count);
+            if (victim != self) job = m_workers[victim]->deque.Steal();
+        }
+        stolen = job != nullptr;
+    }
+    if (!job) return false;
+
+    // Copy out first: once taken, the ring slot may be reused by its owner
+    const Job local = *job;
+    m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    if (stolen) m_jobsStolen.fetch_add(1, std::memory_order_relaxed);
+    Execute(local);
+    return true;
+}
+
+void DD_JobSystem::Wait(DD_JobCounter& counter)
+{
+    const int self = t_workerIndex;
+    while (!counter.IsDone())
+    {
+        if (m_workers.empty() || !TryRunOne(self)) std::this_thread::yield();
+    }
+}
+
+void DD_JobSystem::WorkerMain(int index)
+{
+    t_workerIndex = index;
+    while (!m_quit.load(std::memory_order_relaxed))
+    {
+        if (TryRunOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        m_wake.wait(lock, [&]()
+        {
+            return m_quit.load(std::memory_order_relaxed) || m_queuedJobs.load(std::memory_order_seq_cst) > 0;
+        });
+        m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include "framework.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+// Counts unfinished jobs. Pass one to Run for every job of a group, then Wait on it.
+// Waiting on a counter is also how jobs express dependencies on other jobs.
+class DD_JobCounter
+{
+public:
+    DD_JobCounter() : m_pending(0) {}
+
+    bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class DD_JobSystem;
+    std::atomic<int> m_pending;
+};
+
+// Job entry point; begin/end is the index range of a ParallelFor chunk, 0/0 for Run
+typedef void (*DD_JobFn)(void* context, int begin, int end);
+
+// Work-stealing job scheduler.
+// Every worker, and the thread that called Initialize, owns a fixed-size Chase-Lev deque:
+// the owner pushes and pops at the bottom without locks, idle threads steal from the top
+// of a random victim. Threads waiting on a counter run jobs instead of blocking, so jobs
+// may submit and wait on further jobs.
+// Web builds without pthreads get zero workers and run everything on the caller.
+class DD_JobSystem : public ISingleton<DD_JobSystem>
+{
+public:
+    DD_JobSystem();
+    virtual ~DD_JobSystem();
+
+    virtual void Initialize() override;
+    virtual void Tick(float deltaTime) override;
+    virtual void Finalize() override;
+
+public:
+    // Queues fn(context, 0, 0). Threads other than the workers and the initializing
+    // thread, or a full deque, run the job immediately instead.
+    void Run(DD_JobFn fn, void* context, DD_JobCounter* counter);
+
+    // Runs jobs until the counter reaches zero
+    void Wait(DD_JobCounter& counter);
+
+    // Calls fn(begin, end) over [0, count) in chunks of at least minChunk indices,
+    // spread over all threads. Returns once every chunk has run.
+    template<typename Fn>
+    void ParallelFor(int count, int minChunk, Fn&& fn)
+    {
+        if (count <= 0) return;
+        const int chunk = ChunkSize(count, minChunk);
+        if (chunk >= count)
+        {
+            fn(0, count);
+            return;
+        }
+
+        typedef typename std::remove_reference<Fn>::type FnType;
+        DD_JobCounter counter;
+        for (int begin = chunk; begin < count; begin += chunk)
+        {
+            const int end = begin + chunk < count ? begin + chunk : count;
+            Submit(&InvokeRange<FnType>, &fn, begin, end, &counter);
+        }
+        // The caller takes the first chunk itself
+        fn(0, chunk);
+        Wait(counter);
+    }
+
+    int GetWorkerCount() const { return static_cast<int>(m_threads.size()); }
+    // Workers plus the initializing thread
+    int GetThreadCount() const { return GetWorkerCount() + 1; }
+
+    // Hardware threads minus the caller, at least zero
+    static int GetDefaultWorkerCount();
+
+    // Totals since Initialize
+    uint64_t GetJobsExecuted() const { return m_jobsExecuted.load(std::memory_order_relaxed); }
+    uint64_t GetJobsStolen() const { return m_jobsStolen.load(std::memory_order_relaxed); }
+
+private:
+    struct Job
+    {
+        DD_JobFn fn;
+        void* context;
+        int begin;
+        int end;
+        DD_JobCounter* counter;
+    };
+
+    // Fixed capacity single-owner deque (Chase-Lev, with the C11 orderings of Le et al.)
+    class Deque
+    {
+    public:
+        static constexpr int64_t Capacity = 1024;
+
+        Deque();
+        bool Push(Job* job);  // Owner only; false when full
+        Job* Pop();           // Owner only
+        Job* Steal();         // Any thread
+
+    private:
+        std::atomic<int64_t> m_top;
+        std::atomic<int64_t> m_bottom;
+        std::atomic<Job*> m_items[Capacity];
+    };
+
+    // Jobs live in a ring twice the deque size, so a slot is never reused while its
+    // job is still queued
+    struct Worker
+    {
+        static constexpr uint32_t RingSize = 2 * Deque::Capacity;
+
+        Deque deque;
+        Job ring[RingSize];
+        uint32_t ringNext = 0;
+        uint32_t random = 0;
+    };
+
+    template<typename Fn>
+    static void InvokeRange(void* context, int begin, int end) { (*static_cast<Fn*>(context))(begin, end); }
+
+    int ChunkSize(int count, int minChunk) const;
+    void Submit(DD_JobFn fn, void* context, int begin, int end, DD_JobCounter* counter);
+    bool TryRunOne(int self);
+    void Execute(const Job& job);
+    void WorkerMain(int index);
+
+private:
+    std::vector<std::unique_ptr<Worker>> m_workers;  // [0] belongs to the initializing thread
+    std::vector<std::thread> m_threads;
+
+    std::atomic<int> m_queuedJobs;
+    std::atomic<int> m_sleepingWorkers;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_quit;
+
+    std::atomic<uint64_t> m_jobsExecuted;
+    std::atomic<uint64_t> m_jobsStolen;
+};
+
+#define gJobSystem (*DD_JobSystem::GetInstance())
@@ -14,7 +14,10 @@ public:
     DD_LightComponent();
     virtual ~DD_LightComponent();
 
-    virtual ComponentType GetType() const override { return ComponentType::Light; }
+    static constexpr ComponentType StaticType = ComponentType::Light;
+    typedef DD_LightComponent SlotClass;
+
+    virtual ComponentType GetType() const override { return StaticType; }
     virtual void Update(float deltaTime) override;
 
     // Light type
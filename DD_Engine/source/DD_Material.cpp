@@ -1,5 +1,8 @@
 #include "DD_Material.h"
 #include "DD_Texture.h"
+#include <atomic>
+
+static std::atomic<uint32_t> s_nextSortId(0);
 
 DD_Material::DD_Material()
     : m_name("Default")
@@ -9,6 +12,7 @@ DD_Material::DD_Material()
     , m_roughnessTex(nullptr)
     , m_aoTex(nullptr)
     , m_emissiveTex(nullptr)
+    , m_sortId(s_nextSortId++)
 {
 }
 
@@ -20,6 +24,7 @@ DD_Material::DD_Material(const std::string& name)
     , m_roughnessTex(nullptr)
     , m_aoTex(nullptr)
     , m_emissiveTex(nullptr)
+    , m_sortId(s_nextSortId++)
 {
 }
 
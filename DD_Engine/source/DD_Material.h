@@ -1,5 +1,6 @@
 #pragma once
 #include "DD_GLHelper.h"
+#include <cstdint>
 #include <string>
 
 class DD_Texture;
@@ -82,6 +83,9 @@ public:
     bool HasAlbedoTexture() const { return m_albedoTex != nullptr; }
     bool HasNormalTexture() const { return m_normalTex != nullptr; }
 
+    // Small unique id for render queue sort keys
+    uint32_t GetSortId() const { return m_sortId; }
+
     // Bind textures to shader slots
     void BindTextures() const;
     void UnbindTextures() const;
@@ -104,4 +108,6 @@ private:
     DD_Texture* m_roughnessTex;
     DD_Texture* m_aoTex;
     DD_Texture* m_emissiveTex;
+
+    uint32_t m_sortId;
 };
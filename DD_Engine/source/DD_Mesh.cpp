@@ -1,10 +1,19 @@
 #include "DD_Mesh.h"
+#include <atomic>
 
-DD_Mesh::DD_Mesh() : m_vao(0), m_vbo(0), m_ibo(0), m_vertexBuffer(0), m_indexBuffer(0), m_indexCount(0), m_color{ 1.0f, 1.0f, 1.0f, 1.0f }
+static std::atomic<uint32_t> s_nextSortId(0);
+
+DD_Mesh::DD_Mesh() : m_vao(0), m_vbo(0), m_ibo(0), m_vertexBuffer(0), m_indexBuffer(0), m_indexCount(0), m_color{ 1.0f, 1.0f, 1.0f, 1.0f }, m_sortId(s_nextSortId++), m_localCenter(0.0f), m_localHalfExtents(1e18f)
 {
 
 }
 
+void DD_Mesh::SetLocalBounds(const Vec3& min, const Vec3& max)
+{
+    m_localCenter = (min + max) * 0.5f;
+    m_localHalfExtents = (max - min) * 0.5f;
+}
+
 DD_Mesh::~DD_Mesh()
 {
     if (m_vao) glDeleteVertexArrays(1, &m_vao);
@@ -18,6 +18,17 @@ public:
     GLuint GetIndexBuffer() const { return m_indexBuffer; }
     int GetIndexCount() const { return m_indexCount; }
 
+    // Small unique id for render queue sort keys
+    uint32_t GetSortId() const { return m_sortId; }
+
+    // Object-space box used for culling. Meshes that never set one get a huge box and
+    // are never culled.
+    const Vec3& GetLocalCenter() const { return m_localCenter; }
+    const Vec3& GetLocalHalfExtents() const { return m_localHalfExtents; }
+
+protected:
+    void SetLocalBounds(const Vec3& min, const Vec3& max);
+
 protected:
     GLuint m_vao;
     GLuint m_vbo;
@@ -26,4 +37,9 @@ protected:
     GLuint m_indexBuffer;
     int m_indexCount;
     Color m_color;
+
+private:
+    uint32_t m_sortId;
+    Vec3 m_localCenter;
+    Vec3 m_localHalfExtents;
 };
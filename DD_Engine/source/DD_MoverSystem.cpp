@@ -0,0 +1,271 @@
+#include "DD_MoverSystem.h"
+#include "DD_Actor.h"
+#include "DD_JobSystem.h"
+#include "DD_SIMD.h"
+#include "DD_TransformStorage.h"
+
+using Simd::BatchFloat;
+using Simd::kBatchLanes;
+using Simd::BatchLoad;
+using Simd::BatchSplat;
+
+static constexpr uint32_t kNoMover = 0xFFFFFFFFu;
+static constexpr float kPi = 3.14159265f;
+static constexpr float kTwoPi = 6.28318531f;
+
+// Movers per job when a group is split across threads
+static constexpr int kParallelBatchMovers = 2048;
+
+// Group ------------------------------------------------------------------------------------
+
+int DD_MoverSystem::Group::Add(DD_Actor* actor)
+{
+    const uint32_t entity = actor->GetEntityId();
+    if (entity >= m_sparse.size()) m_sparse.resize(entity + 1, kNoMover);
+    if (m_sparse[entity] != kNoMover) return static_cast<int>(m_sparse[entity]);
+
+    const int index = Size();
+    m_sparse[entity] = static_cast<uint32_t>(index);
+    m_actors.push_back(actor);
+    m_entities.push_back(entity);
+
+    const size_t padded = (m_actors.size() + kBatchLanes - 1) / kBatchLanes * kBatchLanes;
+    for (auto& column : m_columns) column.resize(padded, 0.0f);
+    return index;
+}
+
+void DD_MoverSystem::Group::Remove(uint32_t entity)
+{
+    if (entity >= m_sparse.size() || m_sparse[entity] == kNoMover) return;
+
+    const uint32_t index = m_sparse[entity];
+    const uint32_t last = static_cast<uint32_t>(Size()) - 1;
+    m_sparse[entity] = kNoMover;
+    if (index != last)
+    {
+        for (auto& column : m_columns) column[index] = column[last];
+        m_actors[index] = m_actors[last];
+        m_entities[index] = m_entities[last];
+        m_sparse[m_entities[index]] = index;
+    }
+    m_actors.pop_back();
+    m_entities.pop_back();
+}
+
+void DD_MoverSystem::Group::Clear()
+{
+    for (auto& column : m_columns) column.clear();
+    m_actors.clear();
+    m_entities.clear();
+    m_sparse.clear();
+}
+
+// DD_MoverSystem ---------------------------------------------------------------------------
+
+DD_MoverSystem::DD_MoverSystem(DD_TransformStorage& transforms)
+    : m_transforms(transforms)
+    , m_oscillators(OscColumnCount)
+    , m_rotators(RotColumnCount)
+    , m_orbits(OrbColumnCount)
+{
+}
+
+// Start angles are wrapped once here; Update keeps them in range
+static float WrapAngle(double angle)
+{
+    angle = std::fmod(angle + kPi, kTwoPi);
+    return angle < 0.0f ? angle + kPi : angle - kPi;
+}
+
+void DD_MoverSystem::AddOscillator(DD_Actor* actor, const Vec3& axis, float amplitude, float frequency, float phase)
+{
+    if (actor->GetEntityId() == DD_Actor::InvalidEntity) return;
+
+    Group& g = m_oscillators;
+    const int i = g.Add(actor);
+    const Vec3 base = actor->GetPosition();
+    const Vec3 scaledAxis = axis * amplitude;
+    g.Column(OscAngle)[i] = WrapAngle(phase);
+    g.Column(OscSpeed)[i] = frequency;
+    g.Column(OscBaseX)[i] = base.x; g.Column(OscBaseY)[i] = base.y; g.Column(OscBaseZ)[i] = base.z;
+    g.Column(OscAxisX)[i] = scaledAxis.x; g.Column(OscAxisY)[i] = scaledAxis.y; g.Column(OscAxisZ)[i] = scaledAxis.z;
+}
+
+void DD_MoverSystem::AddRotator(DD_Actor* actor, const Vec3& axis, float speed, float phase)
+{
+    if (actor->GetEntityId() == DD_Actor::InvalidEntity) return;
+
+    Group& g = m_rotators;
+    const int i = g.Add(actor);
+    const Vec3 unitAxis = glm::normalize(axis);
+    const Quaternion base = actor->GetRotationQuat();
+    // The quaternion of a rotation by a uses a / 2, so the half angle is what advances
+    g.Column(RotAngle)[i] = WrapAngle(phase * 0.5f);
+    g.Column(RotSpeed)[i] = speed * 0.5f;
+    g.Column(RotAxisX)[i] = unitAxis.x; g.Column(RotAxisY)[i] = unitAxis.y; g.Column(RotAxisZ)[i] = unitAxis.z;
+    g.Column(RotBaseX)[i] = base.x; g.Column(RotBaseY)[i] = base.y; g.Column(RotBaseZ)[i] = base.z; g.Column(RotBaseW)[i] = base.w;
+}
+
+void DD_MoverSystem::AddOrbit(DD_Actor* actor, const Vec3& center, const Vec3& u, const Vec3& v, float speed, float phase)
+{
+    if (actor->GetEntityId() == DD_Actor::InvalidEntity) return;
+
+    Group& g = m_orbits;
+    const int i = g.Add(actor);
+    g.Column(OrbAngle)[i] = WrapAngle(phase);
+    g.Column(OrbSpeed)[i] = speed;
+    g.Column(OrbCenterX)[i] = center.x; g.Column(OrbCenterY)[i] = center.y; g.Column(OrbCenterZ)[i] = center.z;
+    g.Column(OrbUX)[i] = u.x; g.Column(OrbUY)[i] = u.y; g.Column(OrbUZ)[i] = u.z;
+    g.Column(OrbVX)[i] = v.x; g.Column(OrbVY)[i] = v.y; g.Column(OrbVZ)[i] = v.z;
+}
+
+void DD_MoverSystem::Remove(uint32_t entity)
+{
+    m_oscillators.Remove(entity);
+    m_rotators.Remove(entity);
+    m_orbits.Remove(entity);
+}
+
+void DD_MoverSystem::Clear()
+{
+    m_oscillators.Clear();
+    m_rotators.Clear();
+    m_orbits.Clear();
+}
+
+// Advances the angle column of one batch and returns the new angles
+static BatchFloat AdvanceAngle(float* angle, const float* speed, int first, BatchFloat deltaTime)
+{
+    const BatchFloat pi = BatchSplat(kPi);
+    const BatchFloat twoPi = BatchSplat(kTwoPi);
+    BatchFloat a = Simd::MulAdd(BatchLoad(speed + first), deltaTime, BatchLoad(angle + first));
+    a = Simd::Select(Simd::CmpGt(a, pi), Simd::Sub(a, twoPi), a);
+    a = Simd::Select(Simd::CmpLt(a, Simd::Sub(BatchSplat(0.0f), pi)), Simd::Add(a, twoPi), a);
+    Simd::Store(angle + first, a);
+    return a;
+}
+
+template<typename Fn>
+void DD_MoverSystem::ForEachBatch(Group& group, Fn&& update)
+{
+    const int count = group.Size();
+    if (count == 0) return;
+
+    const int batchCount = (count + kBatchLanes - 1) / kBatchLanes;
+    const int batchesPerJob = kParallelBatchMovers / kBatchLanes;
+    if (batchCount <= batchesPerJob)
+    {
+        update(0, count);
+        return;
+    }
+
+    // Each mover writes only its own actor, so batches are independent
+    gJobSystem.ParallelFor(batchCount, batchesPerJob, [&](int firstBatch, int endBatch)
+    {
+        const int end = endBatch * kBatchLanes < count ? endBatch * kBatchLanes : count;
+        update(firstBatch * kBatchLanes, end);
+    });
+}
+
+void DD_MoverSystem::Update(float deltaTime)
+{
+    ForEachBatch(m_oscillators, [&](int first, int end) { UpdateOscillators(first, end, deltaTime); });
+    ForEachBatch(m_rotators, [&](int first, int end) { UpdateRotators(first, end, deltaTime); });
+    // Last, so an orbit overrides an oscillator on the same actor
+    ForEachBatch(m_orbits, [&](int first, int end) { UpdateOrbits(first, end, deltaTime); });
+}
+
+// first is a multiple of kBatchLanes; the last batch may run past end into padding
+void DD_MoverSystem::UpdateOscillators(int first, int end, float deltaTime)
+{
+    Group& g = m_oscillators;
+    DD_TransformStorage& storage = m_transforms;
+    const BatchFloat dt = BatchSplat(deltaTime);
+    float px[kBatchLanes], py[kBatchLanes], pz[kBatchLanes];
+
+    for (int batch = first; batch < end; batch += kBatchLanes)
+    {
+        const BatchFloat c = Simd::BatchCos(AdvanceAngle(g.Column(OscAngle), g.Column(OscSpeed), batch, dt));
+        Simd::Store(px, Simd::MulAdd(BatchLoad(g.Column(OscAxisX) + batch), c, BatchLoad(g.Column(OscBaseX) + batch)));
+        Simd::Store(py, Simd::MulAdd(BatchLoad(g.Column(OscAxisY) + batch), c, BatchLoad(g.Column(OscBaseY) + batch)));
+        Simd::Store(pz, Simd::MulAdd(BatchLoad(g.Column(OscAxisZ) + batch), c, BatchLoad(g.Column(OscBaseZ) + batch)));
+
+        const int lanes = end - batch < kBatchLanes ? end - batch : kBatchLanes;
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            const int slot = g.GetActor(batch + lane)->GetTransformIndex();
+            storage.SetPosition(slot, Vec3(px[lane], py[lane], pz[lane]));
+            storage.NotifyOwner(slot);
+        }
+    }
+}
+
+void DD_MoverSystem::UpdateRotators(int first, int end, float deltaTime)
+{
+    Group& g = m_rotators;
+    DD_TransformStorage& storage = m_transforms;
+    const BatchFloat dt = BatchSplat(deltaTime);
+    float qx[kBatchLanes], qy[kBatchLanes], qz[kBatchLanes], qw[kBatchLanes];
+
+    for (int batch = first; batch < end; batch += kBatchLanes)
+    {
+        const BatchFloat halfAngle = AdvanceAngle(g.Column(RotAngle), g.Column(RotSpeed), batch, dt);
+        const BatchFloat s = Simd::BatchSin(halfAngle);
+        const BatchFloat c = Simd::BatchCos(halfAngle);
+
+        // spin * base, spin = (c, axis * s)
+        const BatchFloat ax = Simd::Mul(BatchLoad(g.Column(RotAxisX) + batch), s);
+        const BatchFloat ay = Simd::Mul(BatchLoad(g.Column(RotAxisY) + batch), s);
+        const BatchFloat az = Simd::Mul(BatchLoad(g.Column(RotAxisZ) + batch), s);
+        const BatchFloat bx = BatchLoad(g.Column(RotBaseX) + batch);
+        const BatchFloat by = BatchLoad(g.Column(RotBaseY) + batch);
+        const BatchFloat bz = BatchLoad(g.Column(RotBaseZ) + batch);
+        const BatchFloat bw = BatchLoad(g.Column(RotBaseW) + batch);
+
+        using Simd::Add; using Simd::Sub; using Simd::Mul;
+        Simd::Store(qw, Sub(Mul(c, bw), Add(Add(Mul(ax, bx), Mul(ay, by)), Mul(az, bz))));
+        Simd::Store(qx, Add(Add(Mul(c, bx), Mul(bw, ax)), Sub(Mul(ay, bz), Mul(az, by))));
+        Simd::Store(qy, Add(Add(Mul(c, by), Mul(bw, ay)), Sub(Mul(az, bx), Mul(ax, bz))));
+        Simd::Store(qz, Add(Add(Mul(c, bz), Mul(bw, az)), Sub(Mul(ax, by), Mul(ay, bx))));
+
+        const int lanes = end - batch < kBatchLanes ? end - batch : kBatchLanes;
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            const int slot = g.GetActor(batch + lane)->GetTransformIndex();
+            storage.SetRotation(slot, Quaternion(qw[lane], qx[lane], qy[lane], qz[lane]));
+            storage.NotifyOwner(slot);
+        }
+    }
+}
+
+void DD_MoverSystem::UpdateOrbits(int first, int end, float deltaTime)
+{
+    Group& g = m_orbits;
+    DD_TransformStorage& storage = m_transforms;
+    const BatchFloat dt = BatchSplat(deltaTime);
+    float px[kBatchLanes], py[kBatchLanes], pz[kBatchLanes];
+
+    for (int batch = first; batch < end; batch += kBatchLanes)
+    {
+        const BatchFloat angle = AdvanceAngle(g.Column(OrbAngle), g.Column(OrbSpeed), batch, dt);
+        const BatchFloat s = Simd::BatchSin(angle);
+        const BatchFloat c = Simd::BatchCos(angle);
+
+        auto axis = [&](int center, int u, int v)
+        {
+            const BatchFloat p = Simd::MulAdd(BatchLoad(g.Column(u) + batch), c, BatchLoad(g.Column(center) + batch));
+            return Simd::MulAdd(BatchLoad(g.Column(v) + batch), s, p);
+        };
+        Simd::Store(px, axis(OrbCenterX, OrbUX, OrbVX));
+        Simd::Store(py, axis(OrbCenterY, OrbUY, OrbVY));
+        Simd::Store(pz, axis(OrbCenterZ, OrbUZ, OrbVZ));
+
+        const int lanes = end - batch < kBatchLanes ? end - batch : kBatchLanes;
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            const int slot = g.GetActor(batch + lane)->GetTransformIndex();
+            storage.SetPosition(slot, Vec3(px[lane], py[lane], pz[lane]));
+            storage.NotifyOwner(slot);
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "DD_GLHelper.h"
+#include <cstdint>
+#include <vector>
+
+class DD_Actor;
+class DD_TransformStorage;
+
+// Procedural motion for actors that animate without logic of their own.
+// Each kind of mover lives in structure-of-arrays columns and is evaluated kBatchLanes
+// movers at a time with the SIMD sin/cos from DD_SIMD.h; results go straight into the
+// world's DD_TransformStorage. Every mover advances its own angle, wrapped to [-pi, pi],
+// so precision does not decay with simulation time.
+//
+// An actor has at most one mover of each kind. Oscillators and orbits both drive the
+// position; if an actor has both, the orbit wins. Actors must be in the world, which
+// removes their movers when it removes them.
+class DD_MoverSystem
+{
+public:
+    explicit DD_MoverSystem(DD_TransformStorage& transforms);
+
+    // Moves along axis around the position the actor has now:
+    // base + axis * amplitude * cos(angle), with angle advancing by frequency rad/s
+    void AddOscillator(DD_Actor* actor, const Vec3& axis, float amplitude, float frequency, float phase = 0.0f);
+
+    // Spins about axis at speed rad/s, on top of the rotation the actor has now
+    void AddRotator(DD_Actor* actor, const Vec3& axis, float speed, float phase = 0.0f);
+
+    // Follows the ellipse center + u * cos(angle) + v * sin(angle); the lengths of u and v
+    // are the radii. speed is in rad/s.
+    void AddOrbit(DD_Actor* actor, const Vec3& center, const Vec3& u, const Vec3& v, float speed, float phase = 0.0f);
+
+    // Removes every mover of the entity
+    void Remove(uint32_t entity);
+    void Clear();
+
+    // Advances all movers. |speed * deltaTime| must stay below 2 pi.
+    void Update(float deltaTime);
+
+    int GetOscillatorCount() const { return m_oscillators.Size(); }
+    int GetRotatorCount() const { return m_rotators.Size(); }
+    int GetOrbitCount() const { return m_orbits.Size(); }
+
+private:
+    // Movers of one kind. Columns are padded to a whole number of batches; padding lanes
+    // are evaluated and ignored.
+    class Group
+    {
+    public:
+        explicit Group(int columnCount) : m_columns(columnCount) {}
+
+        int Size() const { return static_cast<int>(m_actors.size()); }
+        float* Column(int column) { return m_columns[column].data(); }
+        DD_Actor* GetActor(int index) const { return m_actors[index]; }
+
+        // Index of the entity's mover, new or replaced
+        int Add(DD_Actor* actor);
+        void Remove(uint32_t entity);
+        void Clear();
+
+    private:
+        std::vector<std::vector<float>> m_columns;
+        std::vector<DD_Actor*> m_actors;
+        std::vector<uint32_t> m_entities;
+        std::vector<uint32_t> m_sparse;  // Index per entity
+    };
+
+    enum OscillatorColumn { OscAngle, OscSpeed, OscBaseX, OscBaseY, OscBaseZ, OscAxisX, OscAxisY, OscAxisZ, OscColumnCount };
+    enum RotatorColumn { RotAngle, RotSpeed, RotAxisX, RotAxisY, RotAxisZ, RotBaseX, RotBaseY, RotBaseZ, RotBaseW, RotColumnCount };
+    enum OrbitColumn { OrbAngle, OrbSpeed, OrbCenterX, OrbCenterY, OrbCenterZ, OrbUX, OrbUY, OrbUZ, OrbVX, OrbVY, OrbVZ, OrbColumnCount };
+
+    void UpdateOscillators(int first, int end, float deltaTime);
+    void UpdateRotators(int first, int end, float deltaTime);
+    void UpdateOrbits(int first, int end, float deltaTime);
+
+    // Runs update over whole batches of the group, in parallel when it is large
+    template<typename Fn>
+    void ForEachBatch(Group& group, Fn&& update);
+
+private:
+    DD_TransformStorage& m_transforms;
+    Group m_oscillators;
+    Group m_rotators;
+    Group m_orbits;
+};
@@ -0,0 +1,127 @@
+#include "DD_RenderQueue.h"
+#include "DD_Mesh.h"
+#include "DD_Material.h"
+#include <algorithm>
+
+constexpr uint32_t DD_RenderQueue::kMinInstanceCount;
+
+DD_RenderQueue::~DD_RenderQueue()
+{
+    if (m_instanceBuffer) glDeleteBuffers(1, &m_instanceBuffer);
+}
+
+uint64_t DD_RenderQueue::MakeKey(RenderPass pass, uint32_t program, uint32_t material, uint32_t mesh, float depth01)
+{
+    const float d = depth01 > 0.0f ? (depth01 < 1.0f ? depth01 : 1.0f) : 0.0f;
+    const uint64_t depthBits = static_cast<uint64_t>(d * 16777215.0f);
+
+    return (static_cast<uint64_t>(pass) & 0xF) << 60
+         | (static_cast<uint64_t>(program) & 0xF) << 56
+         | (static_cast<uint64_t>(material) & 0xFFFF) << 40
+         | (static_cast<uint64_t>(mesh) & 0xFFFF) << 24
+         | depthBits;
+}
+
+void DD_RenderQueue::Clear()
+{
+    m_packets.clear();
+    m_batches.clear();
+    m_instanceModels.clear();
+    for (int i = 0; i < static_cast<int>(RenderPass::Count); ++i)
+    {
+        m_passCount[i] = 0;
+        m_passStart[i] = 0;
+    }
+    for (int i = 0; i <= static_cast<int>(RenderPass::Count); ++i) m_passBatchStart[i] = 0;
+}
+
+void DD_RenderQueue::Add(RenderPass pass, uint32_t program, const Matrix4* model, DD_Mesh* mesh, DD_Material* material, float depth01)
+{
+    // Ids only group draws; wrapped ids that collide cost a bind, the submit compares pointers
+    const uint32_t materialId = material ? material->GetSortId() + 1 : 0;
+
+    DrawPacket packet;
+    packet.key = MakeKey(pass, program, materialId, mesh->GetSortId(), depth01);
+    packet.model = model;
+    packet.mesh = mesh;
+    packet.material = material;
+    m_packets.push_back(packet);
+    ++m_passCount[static_cast<int>(pass)];
+}
+
+void DD_RenderQueue::Sort()
+{
+    std::sort(m_packets.begin(), m_packets.end(),
+        [](const DrawPacket& a, const DrawPacket& b) { return a.key < b.key; });
+
+    // The pass is the top of the key, so passes are contiguous in enum order
+    uint32_t start = 0;
+    for (int i = 0; i < static_cast<int>(RenderPass::Count); ++i)
+    {
+        m_passStart[i] = start;
+        start += m_passCount[i];
+    }
+
+    m_batches.clear();
+    m_instanceModels.clear();
+    for (int i = 0; i < static_cast<int>(RenderPass::Count); ++i)
+    {
+        m_passBatchStart[i] = static_cast<uint32_t>(m_batches.size());
+        BuildBatches(i);
+    }
+    m_passBatchStart[static_cast<int>(RenderPass::Count)] = static_cast<uint32_t>(m_batches.size());
+}
+
+void DD_RenderQueue::BuildBatches(int pass)
+{
+    const uint32_t passBegin = static_cast<uint32_t>(m_batches.size());
+    const uint32_t end = m_passStart[pass] + m_passCount[pass];
+
+    uint32_t i = m_passStart[pass];
+    while (i < end)
+    {
+        // Sort ids can wrap, so runs are cut on the pointers themselves
+        const DrawPacket& first = m_packets[i];
+        const uint32_t program = GetProgram(first.key);
+        uint32_t runEnd = i + 1;
+        while (runEnd < end && m_packets[runEnd].mesh == first.mesh && m_packets[runEnd].material == first.material
+            && GetProgram(m_packets[runEnd].key) == program)
+        {
+            ++runEnd;
+        }
+
+        Batch batch;
+        batch.first = i;
+        batch.count = runEnd - i;
+        batch.program = program;
+        batch.firstInstance = 0;
+        if (m_instancing && batch.count >= kMinInstanceCount)
+        {
+            batch.program = ProgramInstanced;
+            batch.firstInstance = static_cast<uint32_t>(m_instanceModels.size());
+            for (uint32_t p = i; p < runEnd; ++p) m_instanceModels.push_back(*m_packets[p].model);
+        }
+        m_batches.push_back(batch);
+        i = runEnd;
+    }
+
+    // Group the pass's batches by program so it switches at most once per variant.
+    // Stable, so each program keeps the key order.
+    std::stable_sort(m_batches.begin() + passBegin, m_batches.end(),
+        [](const Batch& a, const Batch& b) { return a.program < b.program; });
+}
+
+void DD_RenderQueue::UploadInstances()
+{
+    if (m_instanceModels.empty()) return;
+
+    const size_t bytes = m_instanceModels.size() * sizeof(Matrix4);
+    if (!m_instanceBuffer) glGenBuffers(1, &m_instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    // Grow with headroom so a slowly growing scene keeps one size
+    if (bytes > m_instanceBufferSize) m_instanceBufferSize = bytes + bytes / 2;
+    // Orphan last frame's storage instead of waiting for draws still reading it
+    glBufferData(GL_ARRAY_BUFFER, m_instanceBufferSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_instanceModels.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
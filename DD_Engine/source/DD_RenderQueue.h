@@ -0,0 +1,185 @@
+#pragma once
+#include "DD_GLHelper.h"
+#include <cstdint>
+#include <vector>
+
+class DD_Mesh;
+class DD_Material;
+
+enum class RenderPass : uint8_t
+{
+    Shadow = 0,
+    Geometry,  // Deferred G-buffer fill
+    Forward,   // Lit scene pass
+    Count
+};
+
+// Program variants of the pass renderers, selected per batch by the queue
+enum ProgramVariant : uint32_t
+{
+    ProgramDefault = 0,  // Model matrix from a uniform
+    ProgramInstanced,    // Model matrices from the instance buffer
+    ProgramVariantCount
+};
+
+struct DrawPacket
+{
+    uint64_t key;
+    const Matrix4* model;   // World matrix of the owner, valid until the next transform update
+    DD_Mesh* mesh;
+    DD_Material* material;  // nullptr draws with the default material
+};
+
+// Per-frame counters of the sorted submission
+struct RenderStats
+{
+    uint32_t draws = 0;            // Objects drawn
+    uint32_t drawCalls = 0;
+    uint32_t instancedDrawCalls = 0;
+    uint32_t programBinds = 0;
+    uint32_t materialBinds = 0;
+    uint32_t meshBinds = 0;
+    // Material uploads and mesh binds skipped, against one of each per draw
+    uint32_t stateChangesAvoided = 0;
+
+    // Frustum culling, per RenderPass, of the mesh instances eligible for the pass
+    uint32_t visible[static_cast<int>(RenderPass::Count)] = {};
+    uint32_t culled[static_cast<int>(RenderPass::Count)] = {};
+};
+
+// Draw packets of one frame, sorted so draws that share state are adjacent.
+// Key layout, most significant first:
+//   pass (4) | program (4) | material (16) | mesh (16) | depth (24)
+// Program is a variant index of the pass's renderer. Depth is quantized front to back,
+// so within one state group nearer draws go first and fail fewer depth tests.
+//
+// Sorting also cuts each pass into batches of equal program, material and mesh. Batches
+// of at least kMinInstanceCount packets are drawn instanced, with their model matrices
+// gathered into one buffer uploaded once per frame.
+class DD_RenderQueue
+{
+public:
+    // Below this the per-draw uniform path is cheaper than the instance attribute setup
+    static constexpr uint32_t kMinInstanceCount = 4;
+
+    DD_RenderQueue() = default;
+    ~DD_RenderQueue();
+    DD_RenderQueue(const DD_RenderQueue&) = delete;
+    DD_RenderQueue& operator=(const DD_RenderQueue&) = delete;
+
+    static uint64_t MakeKey(RenderPass pass, uint32_t program, uint32_t material, uint32_t mesh, float depth01);
+    static uint32_t GetProgram(uint64_t key) { return static_cast<uint32_t>(key >> 56) & 0xF; }
+
+    void Clear();
+    // depth01 is the view depth over the far plane; values outside [0, 1] are clamped
+    void Add(RenderPass pass, uint32_t program, const Matrix4* model, DD_Mesh* mesh, DD_Material* material, float depth01);
+    void Sort();
+    // Sends the instance matrices gathered by Sort to the GPU; call before Submit
+    void UploadInstances();
+
+    void SetInstancingEnabled(bool enabled) { m_instancing = enabled; }
+    bool IsInstancingEnabled() const { return m_instancing; }
+
+    uint32_t GetCount(RenderPass pass) const { return m_passCount[static_cast<int>(pass)]; }
+    uint32_t GetTotalCount() const { return static_cast<uint32_t>(m_packets.size()); }
+
+    // Walks one sorted pass and tells the backend only about state that changed:
+    //   void BindProgram(uint32_t program);           // Also invalidates material and mesh
+    //   void BindMaterial(const DD_Material* material);
+    //   void BindMesh(const DD_Mesh* mesh);
+    //   void Draw(const Matrix4& model, const DD_Mesh* mesh);
+    //   void DrawInstanced(GLuint instanceBuffer, uint32_t firstInstance, uint32_t count, const DD_Mesh* mesh);
+    //   void UnbindMesh();                             // Once, after the last draw
+    template<typename Backend>
+    void Submit(RenderPass pass, Backend& backend, RenderStats& stats) const;
+
+private:
+    // Run of packets sharing pass, program, material and mesh
+    struct Batch
+    {
+        uint32_t first;
+        uint32_t count;
+        uint32_t program;
+        uint32_t firstInstance;  // Into m_instanceModels, when program is ProgramInstanced
+    };
+
+    void BuildBatches(int pass);
+
+private:
+    std::vector<DrawPacket> m_packets;
+    uint32_t m_passCount[static_cast<int>(RenderPass::Count)] = {};
+    uint32_t m_passStart[static_cast<int>(RenderPass::Count)] = {};
+
+    std::vector<Batch> m_batches;
+    uint32_t m_passBatchStart[static_cast<int>(RenderPass::Count) + 1] = {};
+    std::vector<Matrix4> m_instanceModels;
+    GLuint m_instanceBuffer = 0;
+    size_t m_instanceBufferSize = 0;  // Bytes
+    bool m_instancing = true;
+};
+
+template<typename Backend>
+void DD_RenderQueue::Submit(RenderPass pass, Backend& backend, RenderStats& stats) const
+{
+    const uint32_t batchBegin = m_passBatchStart[static_cast<int>(pass)];
+    const uint32_t batchEnd = m_passBatchStart[static_cast<int>(pass) + 1];
+    if (batchBegin == batchEnd) return;
+
+    uint32_t program = 0xFFFFFFFFu;
+    const DD_Material* material = nullptr;
+    const DD_Mesh* mesh = nullptr;
+    bool materialBound = false;  // nullptr is a valid material, so track binding separately
+    uint32_t materialBinds = 0;
+    uint32_t meshBinds = 0;
+    uint32_t draws = 0;
+
+    for (uint32_t b = batchBegin; b < batchEnd; ++b)
+    {
+        const Batch& batch = m_batches[b];
+        const DrawPacket& first = m_packets[batch.first];
+
+        if (batch.program != program)
+        {
+            backend.BindProgram(batch.program);
+            program = batch.program;
+            materialBound = false;
+            mesh = nullptr;
+            ++stats.programBinds;
+        }
+        if (!materialBound || first.material != material)
+        {
+            backend.BindMaterial(first.material);
+            material = first.material;
+            materialBound = true;
+            ++materialBinds;
+        }
+        if (first.mesh != mesh)
+        {
+            backend.BindMesh(first.mesh);
+            mesh = first.mesh;
+            ++meshBinds;
+        }
+
+        if (batch.program == ProgramInstanced)
+        {
+            backend.DrawInstanced(m_instanceBuffer, batch.firstInstance, batch.count, first.mesh);
+            ++stats.drawCalls;
+            ++stats.instancedDrawCalls;
+        }
+        else
+        {
+            for (uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+            {
+                backend.Draw(*m_packets[i].model, m_packets[i].mesh);
+            }
+            stats.drawCalls += batch.count;
+        }
+        draws += batch.count;
+    }
+    backend.UnbindMesh();
+
+    stats.draws += draws;
+    stats.materialBinds += materialBinds;
+    stats.meshBinds += meshBinds;
+    stats.stateChangesAvoided += (draws - materialBinds) + (draws - meshBinds);
+}
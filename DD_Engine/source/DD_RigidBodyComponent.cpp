@@ -0,0 +1,16 @@
+#include "DD_RigidBodyComponent.h"
+
+DD_RigidBodyComponent::DD_RigidBodyComponent()
+    : m_velocity(0.0f)
+    , m_gravityScale(1.0f)
+    , m_restitution(0.2f)
+    , m_linearDamping(0.01f)
+    , m_sleepTimer(0.0f)
+    , m_sleeping(false)
+    , m_canSleep(true)
+{
+}
+
+DD_RigidBodyComponent::~DD_RigidBodyComponent()
+{
+}
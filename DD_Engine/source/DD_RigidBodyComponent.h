@@ -0,0 +1,52 @@
+#pragma once
+#include "DD_Component.h"
+
+// Linear rigid body simulated by DD_World. Mass comes from the actor's collision component.
+// Bodies at rest for a while are put to sleep and skipped by the broadphase and solver
+// until something touches them or their velocity is set.
+class DD_RigidBodyComponent : public DD_Component
+{
+public:
+    DD_RigidBodyComponent();
+    virtual ~DD_RigidBodyComponent();
+
+    static constexpr ComponentType StaticType = ComponentType::RigidBody;
+    typedef DD_RigidBodyComponent SlotClass;
+
+    virtual ComponentType GetType() const override { return StaticType; }
+
+    // Velocity (setting it wakes the body)
+    void SetVelocity(const Vec3& velocity) { m_velocity = velocity; WakeUp(); }
+    void AddVelocity(const Vec3& delta) { m_velocity += delta; WakeUp(); }
+    const Vec3& GetVelocity() const { return m_velocity; }
+
+    void SetGravityScale(float scale) { m_gravityScale = scale; }
+    float GetGravityScale() const { return m_gravityScale; }
+
+    // 0 = no bounce, 1 = perfectly elastic
+    void SetRestitution(float restitution) { m_restitution = restitution; }
+    float GetRestitution() const { return m_restitution; }
+
+    void SetLinearDamping(float damping) { m_linearDamping = damping; }
+    float GetLinearDamping() const { return m_linearDamping; }
+
+    // Sleeping
+    void SetCanSleep(bool canSleep) { m_canSleep = canSleep; if (!canSleep) WakeUp(); }
+    bool CanSleep() const { return m_canSleep; }
+    bool IsSleeping() const { return m_sleeping; }
+    void WakeUp() { if (m_sleeping) { m_sleeping = false; m_sleepTimer = 0.0f; } }
+    void PutToSleep() { m_sleeping = true; m_sleepTimer = 0.0f; m_velocity = Vec3(0.0f); }
+
+    // Time spent below the sleep velocity, maintained by the world
+    float GetSleepTimer() const { return m_sleepTimer; }
+    void SetSleepTimer(float seconds) { m_sleepTimer = seconds; }
+
+private:
+    Vec3 m_velocity;
+    float m_gravityScale;
+    float m_restitution;
+    float m_linearDamping;
+    float m_sleepTimer;
+    bool m_sleeping;
+    bool m_canSleep;
+};
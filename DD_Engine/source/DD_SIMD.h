@@ -0,0 +1,250 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+
+//==============================================================================
+// Minimal 4-wide float SIMD wrapper
+// SSE2 on desktop x86/x64, NEON on ARM, WASM SIMD128 on the web (-msimd128),
+// plain scalar code everywhere else.
+//==============================================================================
+
+#if defined(__wasm_simd128__)
+    #define DD_SIMD_WASM 1
+    #include <wasm_simd128.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define DD_SIMD_SSE 1
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #define DD_SIMD_NEON 1
+    #include <arm_neon.h>
+#else
+    #define DD_SIMD_SCALAR 1
+#endif
+
+// 8-wide kernels when the target has AVX2 (-mavx2, /arch:AVX2). Off by default; enable
+// with the DD_ENABLE_AVX2 CMake option or msbuild /p:DDEnableAVX2=true.
+#if defined(__AVX2__)
+    #define DD_SIMD_AVX 1
+    #include <immintrin.h>
+#endif
+
+namespace Simd
+{
+#if DD_SIMD_SSE
+    typedef __m128 Float4;
+    typedef __m128 Mask4;
+
+    inline Float4 Load(const float* p) { return _mm_loadu_ps(p); }
+    inline void Store(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+    inline Float4 Set1(float s) { return _mm_set1_ps(s); }
+    inline Float4 Set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+
+    inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+    inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+    inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+    inline Float4 Div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+    inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+    inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+    inline Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a); }
+    inline Float4 Abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+
+    inline Mask4 CmpLt(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+    inline Mask4 CmpLe(Float4 a, Float4 b) { return _mm_cmple_ps(a, b); }
+    inline Mask4 CmpGt(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+    inline Mask4 CmpGe(Float4 a, Float4 b) { return _mm_cmpge_ps(a, b); }
+    inline Mask4 MaskAnd(Mask4 a, Mask4 b) { return _mm_and_ps(a, b); }
+    inline Mask4 MaskOr(Mask4 a, Mask4 b) { return _mm_or_ps(a, b); }
+    inline Mask4 MaskNot(Mask4 a) { return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+    // Picks a where mask is set, b elsewhere
+    inline Float4 Select(Mask4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    // One bit per lane, lane 0 in bit 0
+    inline int MoveMask(Mask4 mask) { return _mm_movemask_ps(mask); }
+
+#elif DD_SIMD_NEON
+    typedef float32x4_t Float4;
+    typedef uint32x4_t Mask4;
+
+    inline Float4 Load(const float* p) { return vld1q_f32(p); }
+    inline void Store(float* p, Float4 v) { vst1q_f32(p, v); }
+    inline Float4 Set1(float s) { return vdupq_n_f32(s); }
+    inline Float4 Set(float x, float y, float z, float w) { float v[4] = { x, y, z, w }; return vld1q_f32(v); }
+
+    inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+    inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+    inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+#if defined(__aarch64__) || defined(_M_ARM64)
+    inline Float4 Div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+    inline Float4 Sqrt(Float4 a) { return vsqrtq_f32(a); }
+#else
+    inline Float4 Div(Float4 a, Float4 b)
+    {
+        Float4 r = vrecpeq_f32(b);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        return vmulq_f32(a, r);
+    }
+    inline Float4 Sqrt(Float4 a)
+    {
+        Float4 r = vrsqrteq_f32(a);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        Float4 s = vmulq_f32(a, r);
+        return vbslq_f32(vceqq_f32(a, vdupq_n_f32(0.0f)), a, s);
+    }
+#endif
+    inline Float4 Min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+    inline Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+    inline Float4 Abs(Float4 a) { return vabsq_f32(a); }
+
+    inline Mask4 CmpLt(Float4 a, Float4 b) { return vcltq_f32(a, b); }
+    inline Mask4 CmpLe(Float4 a, Float4 b) { return vcleq_f32(a, b); }
+    inline Mask4 CmpGt(Float4 a, Float4 b) { return vcgtq_f32(a, b); }
+    inline Mask4 CmpGe(Float4 a, Float4 b) { return vcgeq_f32(a, b); }
+    inline Mask4 MaskAnd(Mask4 a, Mask4 b) { return vandq_u32(a, b); }
+    inline Mask4 MaskOr(Mask4 a, Mask4 b) { return vorrq_u32(a, b); }
+    inline Mask4 MaskNot(Mask4 a) { return vmvnq_u32(a); }
+    inline Float4 Select(Mask4 mask, Float4 a, Float4 b) { return vbslq_f32(mask, a, b); }
+    inline int MoveMask(Mask4 mask)
+    {
+        static const int32_t shifts[4] = { 0, 1, 2, 3 };
+        uint32x4_t bits = vshlq_u32(vshrq_n_u32(mask, 31), vld1q_s32(shifts));
+        uint32x2_t sum = vpadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+        return static_cast<int>(vget_lane_u32(vpadd_u32(sum, sum), 0));
+    }
+
+#elif DD_SIMD_WASM
+    typedef v128_t Float4;
+    typedef v128_t Mask4;
+
+    inline Float4 Load(const float* p) { return wasm_v128_load(p); }
+    inline void Store(float* p, Float4 v) { wasm_v128_store(p, v); }
+    inline Float4 Set1(float s) { return wasm_f32x4_splat(s); }
+    inline Float4 Set(float x, float y, float z, float w) { return wasm_f32x4_make(x, y, z, w); }
+
+    inline Float4 Add(Float4 a, Float4 b) { return wasm_f32x4_add(a, b); }
+    inline Float4 Sub(Float4 a, Float4 b) { return wasm_f32x4_sub(a, b); }
+    inline Float4 Mul(Float4 a, Float4 b) { return wasm_f32x4_mul(a, b); }
+    inline Float4 Div(Float4 a, Float4 b) { return wasm_f32x4_div(a, b); }
+    inline Float4 Min(Float4 a, Float4 b) { return wasm_f32x4_pmin(a, b); }
+    inline Float4 Max(Float4 a, Float4 b) { return wasm_f32x4_pmax(a, b); }
+    inline Float4 Sqrt(Float4 a) { return wasm_f32x4_sqrt(a); }
+    inline Float4 Abs(Float4 a) { return wasm_f32x4_abs(a); }
+
+    inline Mask4 CmpLt(Float4 a, Float4 b) { return wasm_f32x4_lt(a, b); }
+    inline Mask4 CmpLe(Float4 a, Float4 b) { return wasm_f32x4_le(a, b); }
+    inline Mask4 CmpGt(Float4 a, Float4 b) { return wasm_f32x4_gt(a, b); }
+    inline Mask4 CmpGe(Float4 a, Float4 b) { return wasm_f32x4_ge(a, b); }
+    inline Mask4 MaskAnd(Mask4 a, Mask4 b) { return wasm_v128_and(a, b); }
+    inline Mask4 MaskOr(Mask4 a, Mask4 b) { return wasm_v128_or(a, b); }
+    inline Mask4 MaskNot(Mask4 a) { return wasm_v128_not(a); }
+    inline Float4 Select(Mask4 mask, Float4 a, Float4 b) { return wasm_v128_bitselect(a, b, mask); }
+    inline int MoveMask(Mask4 mask) { return static_cast<int>(wasm_i32x4_bitmask(mask)); }
+
+#else
+    struct Float4 { float v[4]; };
+    struct Mask4 { bool v[4]; };
+
+    inline Float4 Load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+    inline void Store(float* p, Float4 a) { for (int i = 0; i < 4; ++i) p[i] = a.v[i]; }
+    inline Float4 Set1(float s) { return { { s, s, s, s } }; }
+    inline Float4 Set(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+
+#define DD_SIMD_SCALAR_OP(name, expr) \
+    inline Float4 name(Float4 a, Float4 b) { Float4 r; for (int i = 0; i < 4; ++i) { float x = a.v[i], y = b.v[i]; r.v[i] = (expr); } return r; }
+    DD_SIMD_SCALAR_OP(Add, x + y)
+    DD_SIMD_SCALAR_OP(Sub, x - y)
+    DD_SIMD_SCALAR_OP(Mul, x * y)
+    DD_SIMD_SCALAR_OP(Div, x / y)
+    DD_SIMD_SCALAR_OP(Min, y < x ? y : x)
+    DD_SIMD_SCALAR_OP(Max, x < y ? y : x)
+#undef DD_SIMD_SCALAR_OP
+    inline Float4 Sqrt(Float4 a) { for (int i = 0; i < 4; ++i) a.v[i] = std::sqrt(a.v[i]); return a; }
+    inline Float4 Abs(Float4 a) { for (int i = 0; i < 4; ++i) a.v[i] = std::fabs(a.v[i]); return a; }
+
+#define DD_SIMD_SCALAR_CMP(name, op) \
+    inline Mask4 name(Float4 a, Float4 b) { Mask4 r; for (int i = 0; i < 4; ++i) r.v[i] = a.v[i] op b.v[i]; return r; }
+    DD_SIMD_SCALAR_CMP(CmpLt, <)
+    DD_SIMD_SCALAR_CMP(CmpLe, <=)
+    DD_SIMD_SCALAR_CMP(CmpGt, >)
+    DD_SIMD_SCALAR_CMP(CmpGe, >=)
+#undef DD_SIMD_SCALAR_CMP
+    inline Mask4 MaskAnd(Mask4 a, Mask4 b) { for (int i = 0; i < 4; ++i) a.v[i] = a.v[i] && b.v[i]; return a; }
+    inline Mask4 MaskOr(Mask4 a, Mask4 b) { for (int i = 0; i < 4; ++i) a.v[i] = a.v[i] || b.v[i]; return a; }
+    inline Mask4 MaskNot(Mask4 a) { for (int i = 0; i < 4; ++i) a.v[i] = !a.v[i]; return a; }
+    inline Float4 Select(Mask4 mask, Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] = mask.v[i] ? a.v[i] : b.v[i]; return a; }
+    inline int MoveMask(Mask4 mask) { return (mask.v[0] ? 1 : 0) | (mask.v[1] ? 2 : 0) | (mask.v[2] ? 4 : 0) | (mask.v[3] ? 8 : 0); }
+#endif
+
+    // a * b + c
+    inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return Add(Mul(a, b), c); }
+
+#if DD_SIMD_AVX
+    typedef __m256 Float8;
+    typedef __m256 Mask8;
+
+    inline Float8 Load8(const float* p) { return _mm256_loadu_ps(p); }
+    inline void Store(float* p, Float8 v) { _mm256_storeu_ps(p, v); }
+    inline Float8 Set1x8(float s) { return _mm256_set1_ps(s); }
+
+    inline Float8 Add(Float8 a, Float8 b) { return _mm256_add_ps(a, b); }
+    inline Float8 Sub(Float8 a, Float8 b) { return _mm256_sub_ps(a, b); }
+    inline Float8 Mul(Float8 a, Float8 b) { return _mm256_mul_ps(a, b); }
+    inline Float8 Div(Float8 a, Float8 b) { return _mm256_div_ps(a, b); }
+    inline Float8 Min(Float8 a, Float8 b) { return _mm256_min_ps(a, b); }
+    inline Float8 Max(Float8 a, Float8 b) { return _mm256_max_ps(a, b); }
+    inline Float8 Sqrt(Float8 a) { return _mm256_sqrt_ps(a); }
+    inline Float8 Abs(Float8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    inline Float8 MulAdd(Float8 a, Float8 b, Float8 c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+
+    inline Mask8 CmpLt(Float8 a, Float8 b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    inline Mask8 CmpLe(Float8 a, Float8 b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    inline Mask8 CmpGt(Float8 a, Float8 b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    inline Mask8 CmpGe(Float8 a, Float8 b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    inline Mask8 MaskAnd(Mask8 a, Mask8 b) { return _mm256_and_ps(a, b); }
+    inline Mask8 MaskOr(Mask8 a, Mask8 b) { return _mm256_or_ps(a, b); }
+    inline Mask8 MaskNot(Mask8 a) { return _mm256_xor_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+    inline Float8 Select(Mask8 mask, Float8 a, Float8 b) { return _mm256_blendv_ps(b, a, mask); }
+    inline int MoveMask(Mask8 mask) { return _mm256_movemask_ps(mask); }
+#endif
+
+    // Widest float vector of the target, for kernels that stream SoA arrays
+#if DD_SIMD_AVX
+    typedef Float8 BatchFloat;
+    static constexpr int kBatchLanes = 8;
+    inline BatchFloat BatchLoad(const float* p) { return Load8(p); }
+    inline BatchFloat BatchSplat(float s) { return Set1x8(s); }
+#else
+    typedef Float4 BatchFloat;
+    static constexpr int kBatchLanes = 4;
+    inline BatchFloat BatchLoad(const float* p) { return Load(p); }
+    inline BatchFloat BatchSplat(float s) { return Set1(s); }
+#endif
+
+    // sin(x) for x in [-pi, pi], absolute error below 1e-6.
+    // Folds into [-pi/2, pi/2] by symmetry and evaluates the odd Taylor series to x^11.
+    inline BatchFloat BatchSin(BatchFloat x)
+    {
+        const BatchFloat pi = BatchSplat(3.14159265f);
+        const BatchFloat halfPi = BatchSplat(1.57079633f);
+        x = Select(CmpGt(x, halfPi), Sub(pi, x), x);
+        x = Select(CmpLt(x, Sub(BatchSplat(0.0f), halfPi)), Sub(Sub(BatchSplat(0.0f), pi), x), x);
+
+        const BatchFloat x2 = Mul(x, x);
+        BatchFloat p = BatchSplat(-2.50521084e-8f);
+        p = MulAdd(p, x2, BatchSplat(2.75573192e-6f));
+        p = MulAdd(p, x2, BatchSplat(-1.98412698e-4f));
+        p = MulAdd(p, x2, BatchSplat(8.33333333e-3f));
+        p = MulAdd(p, x2, BatchSplat(-1.66666667e-1f));
+        p = MulAdd(p, x2, BatchSplat(1.0f));
+        return Mul(p, x);
+    }
+
+    // cos(x) for x in [-pi, pi], as sin(x + pi/2) wrapped back into range
+    inline BatchFloat BatchCos(BatchFloat x)
+    {
+        const BatchFloat pi = BatchSplat(3.14159265f);
+        x = Add(x, BatchSplat(1.57079633f));
+        x = Select(CmpGt(x, pi), Sub(x, BatchSplat(6.28318531f)), x);
+        return BatchSin(x);
+    }
+}
@@ -8,23 +8,7 @@
 #include <cstdio>
 #include <glm/gtc/type_ptr.hpp>
 
-GLuint DD_SceneRenderer::s_sceneProgram = 0;
-GLint DD_SceneRenderer::s_modelLoc = -1;
-GLint DD_SceneRenderer::s_viewLoc = -1;
-GLint DD_SceneRenderer::s_projLoc = -1;
-GLint DD_SceneRenderer::s_lightSpaceLoc = -1;
-GLint DD_SceneRenderer::s_shadowMapLoc = -1;
-GLint DD_SceneRenderer::s_lightDirLoc = -1;
-GLint DD_SceneRenderer::s_lightColorLoc = -1;
-GLint DD_SceneRenderer::s_ambientLoc = -1;
-GLint DD_SceneRenderer::s_shadowBiasLoc = -1;
-GLint DD_SceneRenderer::s_cameraPosLoc = -1;
-GLint DD_SceneRenderer::s_albedoLoc = -1;
-GLint DD_SceneRenderer::s_metallicLoc = -1;
-GLint DD_SceneRenderer::s_roughnessLoc = -1;
-GLint DD_SceneRenderer::s_aoLoc = -1;
-GLint DD_SceneRenderer::s_hasAlbedoTexLoc = -1;
-GLint DD_SceneRenderer::s_albedoTexLoc = -1;
+DD_SceneRenderer::SceneProgram DD_SceneRenderer::s_scenePrograms[ProgramVariantCount];
 bool DD_SceneRenderer::s_shadersReady = false;
 
 bool DD_SceneRenderer::CacheShaders()
@@ -40,7 +24,13 @@ bool DD_SceneRenderer::CacheShaders()
         "layout(location = 1) in vec3 aNormal;\n"
         "layout(location = 2) in vec2 aTexCoord;\n"
         "\n"
+        "#ifdef INSTANCED\n"
+        "layout(location = 3) in mat4 aInstanceModel;\n"
+        "#define MODEL aInstanceModel\n"
+        "#else\n"
         "uniform mat4 uModel;\n"
+        "#define MODEL uModel\n"
+        "#endif\n"
         "uniform mat4 uView;\n"
         "uniform mat4 uProjection;\n"
         "uniform mat4 uLightSpace;\n"
@@ -51,9 +41,9 @@ bool DD_SceneRenderer::CacheShaders()
         "out vec4 vLightSpacePos;\n"
         "\n"
         "void main() {\n"
-        "    vec4 worldPos = uModel * vec4(aPos, 1.0);\n"
+        "    vec4 worldPos = MODEL * vec4(aPos, 1.0);\n"
         "    vWorldPos = worldPos.xyz;\n"
-        "    mat3 normalMatrix = transpose(inverse(mat3(uModel)));\n"
+        "    mat3 normalMatrix = transpose(inverse(mat3(MODEL)));\n"
         "    vNormal = normalize(normalMatrix * aNormal);\n"
         "    vTexCoord = aTexCoord;\n"
         "    vLightSpacePos = uLightSpace * worldPos;\n"
@@ -167,7 +157,13 @@ bool DD_SceneRenderer::CacheShaders()
         layout(location = 1) in vec3 aNormal;
         layout(location = 2) in vec2 aTexCoord;
         
+        #ifdef INSTANCED
+        layout(location = 3) in mat4 aInstanceModel;
+        #define MODEL aInstanceModel
+        #else
         uniform mat4 uModel;
+        #define MODEL uModel
+        #endif
         uniform mat4 uView;
         uniform mat4 uProjection;
         uniform mat4 uLightSpace;
@@ -179,9 +175,9 @@ bool DD_SceneRenderer::CacheShaders()
         
         void main()
         {
-            vec4 worldPos = uModel * vec4(aPos, 1.0);
+            vec4 worldPos = MODEL * vec4(aPos, 1.0);
             vWorldPos = worldPos.xyz;
-            mat3 normalMatrix = transpose(inverse(mat3(uModel)));
+            mat3 normalMatrix = transpose(inverse(mat3(MODEL)));
             vNormal = normalize(normalMatrix * aNormal);
             vTexCoord = aTexCoord;
             vLightSpacePos = uLightSpace * worldPos;
@@ -317,92 +313,101 @@ bool DD_SceneRenderer::CacheShaders()
     )";
 #endif
 
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-
-    GLint success;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        printf("Scene vertex shader compilation failed:\n%s\n", infoLog);
-        return false;
-    }
-
     GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
     glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
     glCompileShader(fragmentShader);
 
+    GLint success;
     glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
     if (!success) {
         char infoLog[512];
         glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
         printf("Scene fragment shader compilation failed:\n%s\n", infoLog);
-        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
         return false;
     }
 
-    s_sceneProgram = glCreateProgram();
-    glAttachShader(s_sceneProgram, vertexShader);
-    glAttachShader(s_sceneProgram, fragmentShader);
+    for (uint32_t variant = 0; variant < ProgramVariantCount; ++variant)
+    {
+        const std::string source = variant == ProgramInstanced
+            ? GLHelper::WithDefine(vertexShaderSource, "INSTANCED") : std::string(vertexShaderSource);
+        const char* sourcePtr = source.c_str();
+
+        GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertexShader, 1, &sourcePtr, nullptr);
+        glCompileShader(vertexShader);
+
+        glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
+            printf("Scene vertex shader compilation failed (variant %u):\n%s\n", variant, infoLog);
+            glDeleteShader(vertexShader);
+            glDeleteShader(fragmentShader);
+            return false;
+        }
+
+        SceneProgram& scene = s_scenePrograms[variant];
+        scene.program = glCreateProgram();
+        glAttachShader(scene.program, vertexShader);
+        glAttachShader(scene.program, fragmentShader);
 
 #ifdef __EMSCRIPTEN__
-    glBindAttribLocation(s_sceneProgram, 0, "aPos");
-    glBindAttribLocation(s_sceneProgram, 1, "aNormal");
-    glBindAttribLocation(s_sceneProgram, 2, "aTexCoord");
+        glBindAttribLocation(scene.program, 0, "aPos");
+        glBindAttribLocation(scene.program, 1, "aNormal");
+        glBindAttribLocation(scene.program, 2, "aTexCoord");
 #endif
 
-    glLinkProgram(s_sceneProgram);
-
-    glGetProgramiv(s_sceneProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(s_sceneProgram, 512, nullptr, infoLog);
-        printf("Scene program linking failed:\n%s\n", infoLog);
+        glLinkProgram(scene.program);
         glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        return false;
-    }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+        glGetProgramiv(scene.program, GL_LINK_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetProgramInfoLog(scene.program, 512, nullptr, infoLog);
+            printf("Scene program linking failed (variant %u):\n%s\n", variant, infoLog);
+            glDeleteShader(fragmentShader);
+            return false;
+        }
 
-    // Get uniform locations
-    s_modelLoc = glGetUniformLocation(s_sceneProgram, "uModel");
-    s_viewLoc = glGetUniformLocation(s_sceneProgram, "uView");
-    s_projLoc = glGetUniformLocation(s_sceneProgram, "uProjection");
-    s_lightSpaceLoc = glGetUniformLocation(s_sceneProgram, "uLightSpace");
-    s_shadowMapLoc = glGetUniformLocation(s_sceneProgram, "uShadowMap");
-    s_lightDirLoc = glGetUniformLocation(s_sceneProgram, "uLightDir");
-    s_lightColorLoc = glGetUniformLocation(s_sceneProgram, "uLightColor");
-    s_ambientLoc = glGetUniformLocation(s_sceneProgram, "uAmbient");
-    s_shadowBiasLoc = glGetUniformLocation(s_sceneProgram, "uShadowBias");
-    s_cameraPosLoc = glGetUniformLocation(s_sceneProgram, "uCameraPos");
-    
-    // Material uniforms
-    s_albedoLoc = glGetUniformLocation(s_sceneProgram, "uAlbedo");
-    s_metallicLoc = glGetUniformLocation(s_sceneProgram, "uMetallic");
-    s_roughnessLoc = glGetUniformLocation(s_sceneProgram, "uRoughness");
-    s_aoLoc = glGetUniformLocation(s_sceneProgram, "uAO");
-    s_hasAlbedoTexLoc = glGetUniformLocation(s_sceneProgram, "uHasAlbedoTex");
-    s_albedoTexLoc = glGetUniformLocation(s_sceneProgram, "uAlbedoTex");
-
-    printf("PBR Scene shader created:\n");
-    printf("  model=%d, view=%d, proj=%d, lightSpace=%d, cameraPos=%d\n", 
-           s_modelLoc, s_viewLoc, s_projLoc, s_lightSpaceLoc, s_cameraPosLoc);
-    printf("  albedo=%d, metallic=%d, roughness=%d, ao=%d\n",
-           s_albedoLoc, s_metallicLoc, s_roughnessLoc, s_aoLoc);
+        // Get uniform locations
+        scene.modelLoc = glGetUniformLocation(scene.program, "uModel");
+        scene.viewLoc = glGetUniformLocation(scene.program, "uView");
+        scene.projLoc = glGetUniformLocation(scene.program, "uProjection");
+        scene.lightSpaceLoc = glGetUniformLocation(scene.program, "uLightSpace");
+        scene.shadowMapLoc = glGetUniformLocation(scene.program, "uShadowMap");
+        scene.lightDirLoc = glGetUniformLocation(scene.program, "uLightDir");
+        scene.lightColorLoc = glGetUniformLocation(scene.program, "uLightColor");
+        scene.ambientLoc = glGetUniformLocation(scene.program, "uAmbient");
+        scene.shadowBiasLoc = glGetUniformLocation(scene.program, "uShadowBias");
+        scene.cameraPosLoc = glGetUniformLocation(scene.program, "uCameraPos");
+        
+        // Material uniforms
+        scene.albedoLoc = glGetUniformLocation(scene.program, "uAlbedo");
+        scene.metallicLoc = glGetUniformLocation(scene.program, "uMetallic");
+        scene.roughnessLoc = glGetUniformLocation(scene.program, "uRoughness");
+        scene.aoLoc = glGetUniformLocation(scene.program, "uAO");
+        scene.hasAlbedoTexLoc = glGetUniformLocation(scene.program, "uHasAlbedoTex");
+        scene.albedoTexLoc = glGetUniformLocation(scene.program, "uAlbedoTex");
+
+        printf("PBR Scene shader created (variant %u):\n", variant);
+        printf("  model=%d, view=%d, proj=%d, lightSpace=%d, cameraPos=%d\n", 
+               scene.modelLoc, scene.viewLoc, scene.projLoc, scene.lightSpaceLoc, scene.cameraPosLoc);
+        printf("  albedo=%d, metallic=%d, roughness=%d, ao=%d\n",
+               scene.albedoLoc, scene.metallicLoc, scene.roughnessLoc, scene.aoLoc);
+    }
+    glDeleteShader(fragmentShader);
 
     s_shadersReady = true;
+    return true;
 }
 
 void DD_SceneRenderer::ClearShaders()
 {
-    if (s_sceneProgram)
+    for (SceneProgram& scene : s_scenePrograms)
     {
-        glDeleteProgram(s_sceneProgram);
-        s_sceneProgram = 0;
+        if (scene.program) glDeleteProgram(scene.program);
+        scene = SceneProgram();
     }
     s_shadersReady = false;
 }
@@ -412,6 +417,11 @@ DD_SceneRenderer::DD_SceneRenderer()
     , m_projection(1.0f)
     , m_lightSpaceMatrix(1.0f)
     , m_cameraPos(0.0f)
+    , m_lightDir(0.0f, -1.0f, 0.0f)
+    , m_lightColor(1.0f)
+    , m_ambient(0.0f)
+    , m_shadowBias(0.0f)
+    , m_variant(ProgramVariantCount)
 {
 }
 
@@ -429,29 +439,17 @@ void DD_SceneRenderer::BeginScenePass(const Matrix4& view, const Matrix4& projec
     m_lightSpaceMatrix = lightSpaceMatrix;
     m_cameraPos = cameraPos;
 
-    glUseProgram(s_sceneProgram);
-
-    // Set view/projection uniforms
-    glUniformMatrix4fv(s_viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(s_projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(s_lightSpaceLoc, 1, GL_FALSE, glm::value_ptr(lightSpaceMatrix));
-    glUniform3fv(s_cameraPosLoc, 1, glm::value_ptr(cameraPos));
-
-    // Set light uniforms
-    Vec3 lightDir = light.GetDirection();
-    Vec3 lightColor = light.GetColor() * light.GetIntensity();
-    glUniform3fv(s_lightDirLoc, 1, glm::value_ptr(lightDir));
-    glUniform3fv(s_lightColorLoc, 1, glm::value_ptr(lightColor));
-    glUniform1f(s_ambientLoc, light.GetAmbient());
-    glUniform1f(s_shadowBiasLoc, light.GetShadowBias());
+    m_lightDir = light.GetDirection();
+    m_lightColor = light.GetColor() * light.GetIntensity();
+    m_ambient = light.GetAmbient();
+    m_shadowBias = light.GetShadowBias();
 
     // Bind shadow map to slot 0
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, shadowMap);
-    glUniform1i(s_shadowMapLoc, 0);
-    
-    // Albedo texture slot 1
-    glUniform1i(s_albedoTexLoc, 1);
+
+    m_variant = ProgramVariantCount;
+    BindProgram(ProgramDefault);
 
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
@@ -478,42 +476,74 @@ void DD_SceneRenderer::RenderActorWithMaterial(DD_Actor* actor, DD_Material* mat
     DD_Mesh* mesh = meshComp->GetMesh();
     if (!mesh) return;
 
-    Matrix4 model = actor->GetModelMatrix();
-    glUniformMatrix4fv(s_modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+    BindProgram(ProgramDefault);
+    BindMaterial(material);
+    BindMesh(mesh);
+    Draw(actor->GetModelMatrix(), mesh);
+    UnbindMesh();
+}
+
+void DD_SceneRenderer::BindProgram(uint32_t program)
+{
+    if (program == m_variant) return;
+    m_variant = program;
+
+    const SceneProgram& scene = s_scenePrograms[program];
+    glUseProgram(scene.program);
+
+    // Set view/projection uniforms
+    glUniformMatrix4fv(scene.viewLoc, 1, GL_FALSE, glm::value_ptr(m_view));
+    glUniformMatrix4fv(scene.projLoc, 1, GL_FALSE, glm::value_ptr(m_projection));
+    glUniformMatrix4fv(scene.lightSpaceLoc, 1, GL_FALSE, glm::value_ptr(m_lightSpaceMatrix));
+    glUniform3fv(scene.cameraPosLoc, 1, glm::value_ptr(m_cameraPos));
+
+    // Set light uniforms
+    glUniform3fv(scene.lightDirLoc, 1, glm::value_ptr(m_lightDir));
+    glUniform3fv(scene.lightColorLoc, 1, glm::value_ptr(m_lightColor));
+    glUniform1f(scene.ambientLoc, m_ambient);
+    glUniform1f(scene.shadowBiasLoc, m_shadowBias);
+
+    // Shadow map on slot 0, albedo texture on slot 1
+    glUniform1i(scene.shadowMapLoc, 0);
+    glUniform1i(scene.albedoTexLoc, 1);
+}
 
-    // Set material uniforms
+void DD_SceneRenderer::BindMaterial(const DD_Material* material)
+{
+    const SceneProgram& scene = s_scenePrograms[m_variant];
     if (material)
     {
-        glUniform3fv(s_albedoLoc, 1, glm::value_ptr(material->GetAlbedo()));
-        glUniform1f(s_metallicLoc, material->GetMetallic());
-        glUniform1f(s_roughnessLoc, material->GetRoughness());
-        glUniform1f(s_aoLoc, material->GetAO());
+        glUniform3fv(scene.albedoLoc, 1, glm::value_ptr(material->GetAlbedo()));
+        glUniform1f(scene.metallicLoc, material->GetMetallic());
+        glUniform1f(scene.roughnessLoc, material->GetRoughness());
+        glUniform1f(scene.aoLoc, material->GetAO());
         
         if (material->HasAlbedoTexture())
         {
-            glUniform1i(s_hasAlbedoTexLoc, 1);
+            glUniform1i(scene.hasAlbedoTexLoc, 1);
             glActiveTexture(GL_TEXTURE1);
             material->GetAlbedoTexture()->Bind();
         }
         else
         {
-            glUniform1i(s_hasAlbedoTexLoc, 0);
+            glUniform1i(scene.hasAlbedoTexLoc, 0);
         }
     }
     else
     {
         // Default material
-        glUniform3f(s_albedoLoc, 0.8f, 0.8f, 0.8f);
-        glUniform1f(s_metallicLoc, 0.0f);
-        glUniform1f(s_roughnessLoc, 0.5f);
-        glUniform1f(s_aoLoc, 1.0f);
-        glUniform1i(s_hasAlbedoTexLoc, 0);
+        glUniform3f(scene.albedoLoc, 0.8f, 0.8f, 0.8f);
+        glUniform1f(scene.metallicLoc, 0.0f);
+        glUniform1f(scene.roughnessLoc, 0.5f);
+        glUniform1f(scene.aoLoc, 1.0f);
+        glUniform1i(scene.hasAlbedoTexLoc, 0);
     }
+}
 
-    // Bind mesh buffers and draw
+void DD_SceneRenderer::BindMesh(const DD_Mesh* mesh)
+{
 #ifndef __EMSCRIPTEN__
-    GLuint vao = mesh->GetVAO();
-    if (vao) glBindVertexArray(vao);
+    glBindVertexArray(mesh->GetVAO());
 #else
     glBindBuffer(GL_ARRAY_BUFFER, mesh->GetVertexBuffer());
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->GetIndexBuffer());
@@ -522,11 +552,25 @@ void DD_SceneRenderer::RenderActorWithMaterial(DD_Actor* actor, DD_Material* mat
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec3) + sizeof(glm::vec2), (void*)(sizeof(glm::vec3)));
 #endif
+}
 
+void DD_SceneRenderer::Draw(const Matrix4& model, const DD_Mesh* mesh)
+{
+    glUniformMatrix4fv(s_scenePrograms[m_variant].modelLoc, 1, GL_FALSE, glm::value_ptr(model));
     glDrawElements(GL_TRIANGLES, mesh->GetIndexCount(), GL_UNSIGNED_SHORT, 0);
+}
+
+void DD_SceneRenderer::DrawInstanced(GLuint instanceBuffer, uint32_t firstInstance, uint32_t count, const DD_Mesh* mesh)
+{
+    GLHelper::BindInstanceModels(instanceBuffer, firstInstance);
+    glDrawElementsInstanced(GL_TRIANGLES, mesh->GetIndexCount(), GL_UNSIGNED_SHORT, 0, count);
+    GLHelper::UnbindInstanceModels();
+}
 
+void DD_SceneRenderer::UnbindMesh()
+{
 #ifndef __EMSCRIPTEN__
-    if (vao) glBindVertexArray(0);
+    glBindVertexArray(0);
 #else
     glDisableVertexAttribArray(0);
     glDisableVertexAttribArray(1);
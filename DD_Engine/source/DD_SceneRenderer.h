@@ -1,9 +1,11 @@
 #pragma once
 #include "DD_GLHelper.h"
+#include "DD_RenderQueue.h"
 
 class DD_LightComponent;
 class DD_Actor;
 class DD_Material;
+class DD_Mesh;
 
 class DD_SceneRenderer
 {
@@ -20,6 +22,15 @@ public:
                         const Vec3& cameraPos);
     void RenderActor(DD_Actor* actor);
     void RenderActorWithMaterial(DD_Actor* actor, DD_Material* material);
+
+    // State steps for DD_RenderQueue::Submit; valid between BeginScenePass and EndScenePass
+    void BindProgram(uint32_t program);
+    void BindMaterial(const DD_Material* material);
+    void BindMesh(const DD_Mesh* mesh);
+    void Draw(const Matrix4& model, const DD_Mesh* mesh);
+    void DrawInstanced(GLuint instanceBuffer, uint32_t firstInstance, uint32_t count, const DD_Mesh* mesh);
+    void UnbindMesh();
+
     void EndScenePass();
 
 private:
@@ -28,26 +39,37 @@ private:
     Matrix4 m_lightSpaceMatrix;
     Vec3 m_cameraPos;
 
-    // Static shader resources
-    static GLuint s_sceneProgram;
-    static GLint s_modelLoc;
-    static GLint s_viewLoc;
-    static GLint s_projLoc;
-    static GLint s_lightSpaceLoc;
-    static GLint s_shadowMapLoc;
-    static GLint s_lightDirLoc;
-    static GLint s_lightColorLoc;
-    static GLint s_ambientLoc;
-    static GLint s_shadowBiasLoc;
-    static GLint s_cameraPosLoc;
-    
-    // Material uniforms
-    static GLint s_albedoLoc;
-    static GLint s_metallicLoc;
-    static GLint s_roughnessLoc;
-    static GLint s_aoLoc;
-    static GLint s_hasAlbedoTexLoc;
-    static GLint s_albedoTexLoc;
+    // Per-pass light state, uploaded whenever a program variant is bound
+    Vec3 m_lightDir;
+    Vec3 m_lightColor;
+    float m_ambient;
+    float m_shadowBias;
+    uint32_t m_variant;  // Bound ProgramVariant, ProgramVariantCount when none
+
+    // Static shader resources, one program per ProgramVariant
+    struct SceneProgram
+    {
+        GLuint program = 0;
+        GLint modelLoc = -1;  // -1 in the instanced variant
+        GLint viewLoc = -1;
+        GLint projLoc = -1;
+        GLint lightSpaceLoc = -1;
+        GLint shadowMapLoc = -1;
+        GLint lightDirLoc = -1;
+        GLint lightColorLoc = -1;
+        GLint ambientLoc = -1;
+        GLint shadowBiasLoc = -1;
+        GLint cameraPosLoc = -1;
+
+        // Material uniforms
+        GLint albedoLoc = -1;
+        GLint metallicLoc = -1;
+        GLint roughnessLoc = -1;
+        GLint aoLoc = -1;
+        GLint hasAlbedoTexLoc = -1;
+        GLint albedoTexLoc = -1;
+    };
+    static SceneProgram s_scenePrograms[ProgramVariantCount];
     
     static bool s_shadersReady;
 };
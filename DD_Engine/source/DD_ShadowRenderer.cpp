@@ -6,9 +6,7 @@
 #include <cstdio>
 #include <glm/gtc/type_ptr.hpp>
 
-GLuint DD_ShadowRenderer::s_depthProgram = 0;
-GLint DD_ShadowRenderer::s_depthModelLoc = -1;
-GLint DD_ShadowRenderer::s_depthLightSpaceLoc = -1;
+DD_ShadowRenderer::DepthProgram DD_ShadowRenderer::s_depthPrograms[ProgramVariantCount];
 bool DD_ShadowRenderer::s_shadersReady = false;
 
 bool DD_ShadowRenderer::CacheShaders()
@@ -21,10 +19,16 @@ bool DD_ShadowRenderer::CacheShaders()
         "#version 300 es\n"
         "precision highp float;\n"
         "layout(location = 0) in vec3 aPos;\n"
+        "#ifdef INSTANCED\n"
+        "layout(location = 3) in mat4 aInstanceModel;\n"
+        "#define MODEL aInstanceModel\n"
+        "#else\n"
         "uniform mat4 uModel;\n"
+        "#define MODEL uModel\n"
+        "#endif\n"
         "uniform mat4 uLightSpace;\n"
         "void main() {\n"
-        "    gl_Position = uLightSpace * uModel * vec4(aPos, 1.0);\n"
+        "    gl_Position = uLightSpace * MODEL * vec4(aPos, 1.0);\n"
         "}\n";
 
     const char* fragmentShaderSource =
@@ -40,12 +44,18 @@ bool DD_ShadowRenderer::CacheShaders()
         #version 330 core
         layout(location = 0) in vec3 aPos;
         
+        #ifdef INSTANCED
+        layout(location = 3) in mat4 aInstanceModel;
+        #define MODEL aInstanceModel
+        #else
         uniform mat4 uModel;
+        #define MODEL uModel
+        #endif
         uniform mat4 uLightSpace;
         
         void main()
         {
-            gl_Position = uLightSpace * uModel * vec4(aPos, 1.0);
+            gl_Position = uLightSpace * MODEL * vec4(aPos, 1.0);
         }
     )";
 
@@ -59,60 +69,68 @@ bool DD_ShadowRenderer::CacheShaders()
     )";
 #endif
 
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-
-    GLint success;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        printf("Shadow vertex shader compilation failed:\n%s\n", infoLog);
-        return false;
-    }
-
     GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
     glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
     glCompileShader(fragmentShader);
 
+    GLint success;
     glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
     if (!success) {
         char infoLog[512];
         glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
         printf("Shadow fragment shader compilation failed:\n%s\n", infoLog);
-        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
         return false;
     }
 
-    s_depthProgram = glCreateProgram();
-    glAttachShader(s_depthProgram, vertexShader);
-    glAttachShader(s_depthProgram, fragmentShader);
+    for (uint32_t variant = 0; variant < ProgramVariantCount; ++variant)
+    {
+        const std::string source = variant == ProgramInstanced
+            ? GLHelper::WithDefine(vertexShaderSource, "INSTANCED") : std::string(vertexShaderSource);
+        const char* sourcePtr = source.c_str();
+
+        GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertexShader, 1, &sourcePtr, nullptr);
+        glCompileShader(vertexShader);
+
+        glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
+            printf("Shadow vertex shader compilation failed (variant %u):\n%s\n", variant, infoLog);
+            glDeleteShader(vertexShader);
+            glDeleteShader(fragmentShader);
+            return false;
+        }
+
+        DepthProgram& depth = s_depthPrograms[variant];
+        depth.program = glCreateProgram();
+        glAttachShader(depth.program, vertexShader);
+        glAttachShader(depth.program, fragmentShader);
 
 #ifdef __EMSCRIPTEN__
-    glBindAttribLocation(s_depthProgram, 0, "aPos");
+        glBindAttribLocation(depth.program, 0, "aPos");
 #endif
 
-    glLinkProgram(s_depthProgram);
-
-    glGetProgramiv(s_depthProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(s_depthProgram, 512, nullptr, infoLog);
-        printf("Shadow program linking failed:\n%s\n", infoLog);
+        glLinkProgram(depth.program);
         glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        return false;
-    }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+        glGetProgramiv(depth.program, GL_LINK_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetProgramInfoLog(depth.program, 512, nullptr, infoLog);
+            printf("Shadow program linking failed (variant %u):\n%s\n", variant, infoLog);
+            glDeleteShader(fragmentShader);
+            return false;
+        }
 
-    s_depthModelLoc = glGetUniformLocation(s_depthProgram, "uModel");
-    s_depthLightSpaceLoc = glGetUniformLocation(s_depthProgram, "uLightSpace");
+        depth.modelLoc = glGetUniformLocation(depth.program, "uModel");
+        depth.lightSpaceLoc = glGetUniformLocation(depth.program, "uLightSpace");
 
-    printf("Shadow shader program created (model=%d, lightSpace=%d)\n", 
-           s_depthModelLoc, s_depthLightSpaceLoc);
+        printf("Shadow shader program created (variant %u, model=%d, lightSpace=%d)\n",
+               variant, depth.modelLoc, depth.lightSpaceLoc);
+    }
+    glDeleteShader(fragmentShader);
 
     s_shadersReady = true;
     return true;
@@ -120,10 +138,10 @@ bool DD_ShadowRenderer::CacheShaders()
 
 void DD_ShadowRenderer::ClearShaders()
 {
-    if (s_depthProgram)
+    for (DepthProgram& depth : s_depthPrograms)
     {
-        glDeleteProgram(s_depthProgram);
-        s_depthProgram = 0;
+        if (depth.program) glDeleteProgram(depth.program);
+        depth = DepthProgram();
     }
     s_shadersReady = false;
 }
@@ -133,6 +151,7 @@ DD_ShadowRenderer::DD_ShadowRenderer()
     , m_lightSpaceMatrix(1.0f)
     , m_shadowMapSize(2048)
     , m_initialized(false)
+    , m_variant(ProgramVariantCount)
 {
 }
 
@@ -178,8 +197,8 @@ void DD_ShadowRenderer::BeginShadowPass(const DD_LightComponent& light)
     glClear(GL_DEPTH_BUFFER_BIT);
 
     // Use depth shader
-    glUseProgram(s_depthProgram);
-    glUniformMatrix4fv(s_depthLightSpaceLoc, 1, GL_FALSE, glm::value_ptr(m_lightSpaceMatrix));
+    m_variant = ProgramVariantCount;
+    BindProgram(ProgramDefault);
 
     // Cull front faces to reduce shadow acne
     glEnable(GL_CULL_FACE);
@@ -200,13 +219,26 @@ void DD_ShadowRenderer::RenderActor(DD_Actor* actor)
     DD_Mesh* mesh = meshComp->GetMesh();
     if (!mesh) return;
 
-    Matrix4 model = actor->GetModelMatrix();
-    glUniformMatrix4fv(s_depthModelLoc, 1, GL_FALSE, glm::value_ptr(model));
+    BindProgram(ProgramDefault);
+    BindMesh(mesh);
+    Draw(actor->GetModelMatrix(), mesh);
+    UnbindMesh();
+}
+
+void DD_ShadowRenderer::BindProgram(uint32_t program)
+{
+    if (program == m_variant) return;
+    m_variant = program;
+
+    const DepthProgram& depth = s_depthPrograms[program];
+    glUseProgram(depth.program);
+    glUniformMatrix4fv(depth.lightSpaceLoc, 1, GL_FALSE, glm::value_ptr(m_lightSpaceMatrix));
+}
 
-    // Bind mesh buffers and draw
+void DD_ShadowRenderer::BindMesh(const DD_Mesh* mesh)
+{
 #ifndef __EMSCRIPTEN__
-    GLuint vao = mesh->GetVAO();
-    if (vao) glBindVertexArray(vao);
+    glBindVertexArray(mesh->GetVAO());
 #else
     // Manual attribute binding for WebGL
     glBindBuffer(GL_ARRAY_BUFFER, mesh->GetVertexBuffer());
@@ -215,11 +247,25 @@ void DD_ShadowRenderer::RenderActor(DD_Actor* actor)
     // SimpleVertex has position at offset 0, size 3 floats, stride = sizeof(SimpleVertex) = sizeof(vec3) + sizeof(vec2)
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3) + sizeof(glm::vec2), (void*)0);
 #endif
+}
 
+void DD_ShadowRenderer::Draw(const Matrix4& model, const DD_Mesh* mesh)
+{
+    glUniformMatrix4fv(s_depthPrograms[m_variant].modelLoc, 1, GL_FALSE, glm::value_ptr(model));
     glDrawElements(GL_TRIANGLES, mesh->GetIndexCount(), GL_UNSIGNED_SHORT, 0);
+}
 
+void DD_ShadowRenderer::DrawInstanced(GLuint instanceBuffer, uint32_t firstInstance, uint32_t count, const DD_Mesh* mesh)
+{
+    GLHelper::BindInstanceModels(instanceBuffer, firstInstance);
+    glDrawElementsInstanced(GL_TRIANGLES, mesh->GetIndexCount(), GL_UNSIGNED_SHORT, 0, count);
+    GLHelper::UnbindInstanceModels();
+}
+
+void DD_ShadowRenderer::UnbindMesh()
+{
 #ifndef __EMSCRIPTEN__
-    if (vao) glBindVertexArray(0);
+    glBindVertexArray(0);
 #else
     glDisableVertexAttribArray(0);
 #endif
@@ -1,9 +1,12 @@
 #pragma once
 #include "DD_GLHelper.h"
+#include "DD_RenderQueue.h"
 #include "DD_RenderTarget.h"
 #include <memory>
 
 class DD_Actor;
+class DD_Material;
+class DD_Mesh;
 class DD_LightComponent;
 
 class DD_ShadowRenderer
@@ -19,6 +22,15 @@ public:
     void RenderActor(DD_Actor* actor);
     void EndShadowPass();
 
+    // State steps for DD_RenderQueue::Submit; valid inside the shadow pass.
+    // Depth only, so materials need no state.
+    void BindProgram(uint32_t program);
+    void BindMaterial(const DD_Material*) {}
+    void BindMesh(const DD_Mesh* mesh);
+    void Draw(const Matrix4& model, const DD_Mesh* mesh);
+    void DrawInstanced(GLuint instanceBuffer, uint32_t firstInstance, uint32_t count, const DD_Mesh* mesh);
+    void UnbindMesh();
+
     GLuint GetShadowMap() const;
     Matrix4 GetLightSpaceMatrix() const { return m_lightSpaceMatrix; }
     int GetShadowMapSize() const { return m_shadowMapSize; }
@@ -31,10 +43,15 @@ private:
     Matrix4 m_lightSpaceMatrix;
     int m_shadowMapSize;
     bool m_initialized;
-
-    // Static shader resources
-    static GLuint s_depthProgram;
-    static GLint s_depthModelLoc;
-    static GLint s_depthLightSpaceLoc;
+    uint32_t m_variant;  // Bound ProgramVariant, ProgramVariantCount when none
+
+    // Static shader resources, one program per ProgramVariant
+    struct DepthProgram
+    {
+        GLuint program = 0;
+        GLint modelLoc = -1;  // -1 in the instanced variant
+        GLint lightSpaceLoc = -1;
+    };
+    static DepthProgram s_depthPrograms[ProgramVariantCount];
     static bool s_shadersReady;
 };
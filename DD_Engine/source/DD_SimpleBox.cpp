@@ -196,6 +196,7 @@ void DD_SimpleBox::CreateMesh()
     };
 
     m_indexCount = 36;
+    SetLocalBounds(Vec3(-1.0f), Vec3(1.0f));
 
 #ifndef __EMSCRIPTEN__
     glGenVertexArrays(1, &m_vao);
@@ -0,0 +1,286 @@
+#include "DD_SpatialHashGrid.h"
+#include "framework.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+
+DD_SpatialHashGrid::DD_SpatialHashGrid(float cellSize)
+    : m_cellSize(1.0f)
+    , m_invCellSize(1.0f)
+    , m_proxyCount(0)
+{
+    SetCellSize(cellSize);
+}
+
+DD_SpatialHashGrid::~DD_SpatialHashGrid()
+{
+}
+
+void DD_SpatialHashGrid::SetCellSize(float cellSize)
+{
+    if (cellSize < DD_SMALL_NUMBER) cellSize = 1.0f;
+    m_cellSize = cellSize;
+    m_invCellSize = 1.0f / cellSize;
+
+    m_cells.clear();
+    for (size_t i = 0; i < m_proxies.size(); ++i)
+    {
+        Proxy& proxy = m_proxies[i];
+        if (!proxy.active) continue;
+        proxy.cells = ComputeCellRange(proxy);
+        InsertIntoCells(static_cast<int>(i), proxy.cells);
+    }
+}
+
+void DD_SpatialHashGrid::SetBounds(Proxy& proxy, const AABB& bounds)
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        proxy.minValue[axis] = bounds.center[axis] - bounds.halfExtents[axis];
+        proxy.maxValue[axis] = bounds.center[axis] + bounds.halfExtents[axis];
+    }
+}
+
+DD_SpatialHashGrid::CellRange DD_SpatialHashGrid::ComputeCellRange(const Proxy& proxy) const
+{
+    CellRange range;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        range.min[axis] = static_cast<int>(std::floor(proxy.minValue[axis] * m_invCellSize));
+        range.max[axis] = static_cast<int>(std::floor(proxy.maxValue[axis] * m_invCellSize));
+    }
+    return range;
+}
+
+void DD_SpatialHashGrid::InsertIntoCells(int proxyId, const CellRange& range)
+{
+    for (int x = range.min[0]; x <= range.max[0]; ++x)
+        for (int y = range.min[1]; y <= range.max[1]; ++y)
+            for (int z = range.min[2]; z <= range.max[2]; ++z)
+                m_cells[CellKey(x, y, z)].push_back(proxyId);
+}
+
+void DD_SpatialHashGrid::RemoveFromCells(int proxyId, const CellRange& range)
+{
+    for (int x = range.min[0]; x <= range.max[0]; ++x)
+        for (int y = range.min[1]; y <= range.max[1]; ++y)
+            for (int z = range.min[2]; z <= range.max[2]; ++z)
+            {
+                auto it = m_cells.find(CellKey(x, y, z));
+                if (it == m_cells.end()) continue;
+
+                std::vector<int>& proxies = it->second;
+                auto found = std::find(proxies.begin(), proxies.end(), proxyId);
+                if (found != proxies.end())
+                {
+                    *found = proxies.back();
+                    proxies.pop_back();
+                }
+                if (proxies.empty()) m_cells.erase(it);
+            }
+}
+
+int DD_SpatialHashGrid::CreateProxy(const AABB& bounds, void* userData, const CollisionFilter& filter)
+{
+    int id;
+    if (!m_freeProxies.empty())
+    {
+        id = m_freeProxies.back();
+        m_freeProxies.pop_back();
+    }
+    else
+    {
+        id = static_cast<int>(m_proxies.size());
+        m_proxies.emplace_back();
+    }
+
+    Proxy& proxy = m_proxies[id];
+    proxy.userData = userData;
+    proxy.active = true;
+    SetBounds(proxy, bounds);
+    SetFilter(id, filter);
+    proxy.cells = ComputeCellRange(proxy);
+    InsertIntoCells(id, proxy.cells);
+    ++m_proxyCount;
+    return id;
+}
+
+void DD_SpatialHashGrid::DestroyProxy(int proxyId)
+{
+    if (proxyId < 0 || proxyId >= static_cast<int>(m_proxies.size())) return;
+    Proxy& proxy = m_proxies[proxyId];
+    if (!proxy.active) return;
+
+    RemoveFromCells(proxyId, proxy.cells);
+    proxy.active = false;
+    proxy.userData = nullptr;
+    m_freeProxies.push_back(proxyId);
+    --m_proxyCount;
+}
+
+void DD_SpatialHashGrid::MoveProxy(int proxyId, const AABB& bounds)
+{
+    Proxy& proxy = m_proxies[proxyId];
+    if (!proxy.active) return;
+
+    SetBounds(proxy, bounds);
+    CellRange range = ComputeCellRange(proxy);
+
+    bool sameCells = true;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (range.min[axis] != proxy.cells.min[axis] || range.max[axis] != proxy.cells.max[axis])
+        {
+            sameCells = false;
+            break;
+        }
+    }
+    if (sameCells) return;
+
+    RemoveFromCells(proxyId, proxy.cells);
+    proxy.cells = range;
+    InsertIntoCells(proxyId, range);
+}
+
+bool DD_SpatialHashGrid::TestOverlap(int a, int b) const
+{
+    const Proxy& pa = m_proxies[a];
+    const Proxy& pb = m_proxies[b];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (pa.maxValue[axis] <= pb.minValue[axis] || pb.maxValue[axis] <= pa.minValue[axis])
+            return false;
+    }
+    return true;
+}
+
+void DD_SpatialHashGrid::ComputePairs(std::vector<BroadphasePair>& outPairs)
+{
+    outPairs.clear();
+
+    // Cells are independent, so this loop can be split across workers.
+    // A pair shared by several cells is only reported from the first cell of the
+    // intersection of both cell ranges, which avoids a pair hash set.
+    for (const auto& cell : m_cells)
+    {
+        const std::vector<int>& proxies = cell.second;
+        const size_t count = proxies.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Proxy& pa = m_proxies[proxies[i]];
+            for (size_t j = i + 1; j < count; ++j)
+            {
+                const Proxy& pb = m_proxies[proxies[j]];
+                uint64_t owner = CellKey(
+                    std::max(pa.cells.min[0], pb.cells.min[0]),
+                    std::max(pa.cells.min[1], pb.cells.min[1]),
+                    std::max(pa.cells.min[2], pb.cells.min[2]));
+                if (owner != cell.first) continue;
+                if (!PassesFilter(proxies[i], proxies[j]) || !TestOverlap(proxies[i], proxies[j])) continue;
+
+                int a = proxies[i], b = proxies[j];
+                if (a > b) std::swap(a, b);
+                outPairs.push_back({ a, b });
+            }
+        }
+    }
+    std::sort(outPairs.begin(), outPairs.end());
+}
+
+void DD_SpatialHashGrid::Query(const AABB& bounds, std::vector<int>& outProxies) const
+{
+    Proxy query;
+    SetBounds(query, bounds);
+    CellRange range = ComputeCellRange(query);
+
+    const size_t first = outProxies.size();
+    for (int x = range.min[0]; x <= range.max[0]; ++x)
+        for (int y = range.min[1]; y <= range.max[1]; ++y)
+            for (int z = range.min[2]; z <= range.max[2]; ++z)
+            {
+                auto it = m_cells.find(CellKey(x, y, z));
+                if (it == m_cells.end()) continue;
+
+                for (int proxyId : it->second)
+                {
+                    const Proxy& proxy = m_proxies[proxyId];
+                    bool overlap = true;
+                    for (int axis = 0; axis < 3 && overlap; ++axis)
+                    {
+                        overlap = proxy.maxValue[axis] > query.minValue[axis] && proxy.minValue[axis] < query.maxValue[axis];
+                    }
+                    if (overlap) outProxies.push_back(proxyId);
+                }
+            }
+
+    // Proxies spanning several cells are found more than once
+    std::sort(outProxies.begin() + first, outProxies.end());
+    outProxies.erase(std::unique(outProxies.begin() + first, outProxies.end()), outProxies.end());
+}
+
+void DD_SpatialHashGrid::WalkRay(const Vec3& origin, const Vec3& dir, float maxT, std::vector<int>& outProxies) const
+{
+    const Vec3 end = origin + dir * maxT;
+    int cell[3], endCell[3], step[3];
+    float tNext[3], tDelta[3];
+    int remaining = 1;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        cell[axis] = static_cast<int>(std::floor(origin[axis] * m_invCellSize));
+        endCell[axis] = static_cast<int>(std::floor(end[axis] * m_invCellSize));
+        remaining += std::abs(endCell[axis] - cell[axis]);
+
+        if (fabsf(dir[axis]) < DD_SMALL_NUMBER)
+        {
+            step[axis] = 0;
+            tNext[axis] = FLT_MAX;
+            tDelta[axis] = FLT_MAX;
+            continue;
+        }
+        step[axis] = dir[axis] > 0.0f ? 1 : -1;
+        float boundary = (cell[axis] + (step[axis] > 0 ? 1 : 0)) * m_cellSize;
+        tNext[axis] = (boundary - origin[axis]) / dir[axis];
+        tDelta[axis] = m_cellSize / fabsf(dir[axis]);
+    }
+
+    // One cell per axis crossing, bounded by the cell distance to the end point
+    for (; remaining > 0; --remaining)
+    {
+        auto it = m_cells.find(CellKey(cell[0], cell[1], cell[2]));
+        if (it != m_cells.end())
+        {
+            outProxies.insert(outProxies.end(), it->second.begin(), it->second.end());
+        }
+
+        int axis = 0;
+        if (tNext[1] < tNext[axis]) axis = 1;
+        if (tNext[2] < tNext[axis]) axis = 2;
+        if (tNext[axis] > maxT) break;
+
+        cell[axis] += step[axis];
+        tNext[axis] += tDelta[axis];
+    }
+}
+
+void DD_SpatialHashGrid::QueryRay(const Vec3& origin, const Vec3& dir, float maxT, std::vector<int>& outProxies) const
+{
+    const size_t first = outProxies.size();
+    WalkRay(origin, dir, maxT, outProxies);
+    std::sort(outProxies.begin() + first, outProxies.end());
+    outProxies.erase(std::unique(outProxies.begin() + first, outProxies.end()), outProxies.end());
+}
+
+void DD_SpatialHashGrid::QueryRayPacket(const RayPacket& packet, std::vector<int>& outProxies) const
+{
+    // Rays in a packet need not be coherent, so each one walks its own cells
+    const size_t first = outProxies.size();
+    for (int lane = 0; lane < packet.count; ++lane)
+    {
+        Vec3 origin(packet.originX[lane], packet.originY[lane], packet.originZ[lane]);
+        Vec3 dir(1.0f / packet.invDirX[lane], 1.0f / packet.invDirY[lane], 1.0f / packet.invDirZ[lane]);
+        WalkRay(origin, dir, packet.maxT[lane], outProxies);
+    }
+    std::sort(outProxies.begin() + first, outProxies.end());
+    outProxies.erase(std::unique(outProxies.begin() + first, outProxies.end()), outProxies.end());
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "DD_Broadphase.h"
+#include <unordered_map>
+
+// Uniform hashed grid broadphase.
+// Best for large open worlds with similarly sized boxes. Each proxy is stored in every
+// cell its bounds touch; a proxy is only rehashed when its cell range changes.
+class DD_SpatialHashGrid : public DD_Broadphase
+{
+public:
+    explicit DD_SpatialHashGrid(float cellSize = 4.0f);
+    virtual ~DD_SpatialHashGrid();
+
+    virtual BroadphaseType GetType() const override { return BroadphaseType::SpatialHash; }
+
+    virtual int CreateProxy(const AABB& bounds, void* userData, const CollisionFilter& filter) override;
+    virtual void DestroyProxy(int proxyId) override;
+    virtual void MoveProxy(int proxyId, const AABB& bounds) override;
+    virtual void ComputePairs(std::vector<BroadphasePair>& outPairs) override;
+    virtual void Query(const AABB& bounds, std::vector<int>& outProxies) const override;
+    virtual void QueryRay(const Vec3& origin, const Vec3& dir, float maxT, std::vector<int>& outProxies) const override;
+    virtual void QueryRayPacket(const RayPacket& packet, std::vector<int>& outProxies) const override;
+
+    virtual void* GetUserData(int proxyId) const override { return m_proxies[proxyId].userData; }
+    virtual int GetProxyCount() const override { return m_proxyCount; }
+
+    // Changing the cell size rehashes every proxy
+    void SetCellSize(float cellSize);
+    float GetCellSize() const { return m_cellSize; }
+    size_t GetCellCount() const { return m_cells.size(); }
+
+private:
+    struct CellRange
+    {
+        int min[3];
+        int max[3];
+    };
+
+    struct Proxy
+    {
+        float minValue[3];
+        float maxValue[3];
+        CellRange cells;
+        void* userData = nullptr;
+        bool active = false;
+    };
+
+    static void SetBounds(Proxy& proxy, const AABB& bounds);
+    CellRange ComputeCellRange(const Proxy& proxy) const;
+    void InsertIntoCells(int proxyId, const CellRange& range);
+    void RemoveFromCells(int proxyId, const CellRange& range);
+    bool TestOverlap(int a, int b) const;
+    // Walks the cells along the segment (3D DDA) without sorting the output
+    void WalkRay(const Vec3& origin, const Vec3& dir, float maxT, std::vector<int>& outProxies) const;
+
+    static uint64_t CellKey(int x, int y, int z)
+    {
+        // 21 bits per axis, wraps for very distant cells (only costs extra candidates)
+        return (static_cast<uint64_t>(x & 0x1fffff) << 42)
+             | (static_cast<uint64_t>(y & 0x1fffff) << 21)
+             | static_cast<uint64_t>(z & 0x1fffff);
+    }
+
+private:
+    float m_cellSize;
+    float m_invCellSize;
+    std::unordered_map<uint64_t, std::vector<int>> m_cells;
+    std::vector<Proxy> m_proxies;
+    std::vector<int> m_freeProxies;
+    int m_proxyCount;
+};
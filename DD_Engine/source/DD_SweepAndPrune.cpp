@@ -0,0 +1,261 @@
+#include "DD_SweepAndPrune.h"
+#include <algorithm>
+#include <cfloat>
+
+DD_SweepAndPrune::DD_SweepAndPrune()
+    : m_proxyCount(0)
+{
+}
+
+DD_SweepAndPrune::~DD_SweepAndPrune()
+{
+}
+
+void DD_SweepAndPrune::SetBounds(Proxy& proxy, const AABB& bounds)
+{
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        proxy.minValue[axis] = bounds.center[axis] - bounds.halfExtents[axis];
+        proxy.maxValue[axis] = bounds.center[axis] + bounds.halfExtents[axis];
+    }
+}
+
+int DD_SweepAndPrune::CreateProxy(const AABB& bounds, void* userData, const CollisionFilter& filter)
+{
+    int id;
+    if (!m_freeProxies.empty())
+    {
+        id = m_freeProxies.back();
+        m_freeProxies.pop_back();
+    }
+    else
+    {
+        id = static_cast<int>(m_proxies.size());
+        m_proxies.emplace_back();
+    }
+
+    Proxy& proxy = m_proxies[id];
+    proxy.userData = userData;
+    proxy.active = true;
+    SetBounds(proxy, bounds);
+    SetFilter(id, filter);
+    ++m_proxyCount;
+
+    // Append both endpoints at the end of every axis, then sort them into place.
+    // Bounds are set for all axes first so overlap tests during the sort are exact.
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        std::vector<Endpoint>& endpoints = m_endpoints[axis];
+        uint32_t minIdx = static_cast<uint32_t>(endpoints.size());
+        endpoints.push_back({ proxy.minValue[axis], static_cast<uint32_t>(id) << 1 });
+        endpoints.push_back({ proxy.maxValue[axis], (static_cast<uint32_t>(id) << 1) | 1u });
+        proxy.minIndex[axis] = minIdx;
+        proxy.maxIndex[axis] = minIdx + 1;
+
+        SortMinDown(axis, proxy.minIndex[axis]);
+        SortMaxDown(axis, proxy.maxIndex[axis]);
+    }
+    return id;
+}
+
+void DD_SweepAndPrune::DestroyProxy(int proxyId)
+{
+    if (proxyId < 0 || proxyId >= static_cast<int>(m_proxies.size())) return;
+    Proxy& proxy = m_proxies[proxyId];
+    if (!proxy.active) return;
+
+    // Push both endpoints to the far end of each axis; every pair is removed on the way.
+    // All bounds go to FLT_MAX first so no pair can be re-added while sorting.
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        proxy.minValue[axis] = FLT_MAX;
+        proxy.maxValue[axis] = FLT_MAX;
+    }
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        std::vector<Endpoint>& endpoints = m_endpoints[axis];
+        endpoints[proxy.maxIndex[axis]].value = FLT_MAX;
+        SortMaxUp(axis, proxy.maxIndex[axis]);
+        endpoints[proxy.minIndex[axis]].value = FLT_MAX;
+        SortMinUp(axis, proxy.minIndex[axis]);
+
+        endpoints.pop_back();
+        endpoints.pop_back();
+    }
+
+    proxy.active = false;
+    proxy.userData = nullptr;
+    m_freeProxies.push_back(proxyId);
+    --m_proxyCount;
+}
+
+void DD_SweepAndPrune::MoveProxy(int proxyId, const AABB& bounds)
+{
+    Proxy& proxy = m_proxies[proxyId];
+    if (!proxy.active) return;
+
+    float oldMin[3], oldMax[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        oldMin[axis] = proxy.minValue[axis];
+        oldMax[axis] = proxy.maxValue[axis];
+    }
+    SetBounds(proxy, bounds);
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        std::vector<Endpoint>& endpoints = m_endpoints[axis];
+        endpoints[proxy.minIndex[axis]].value = proxy.minValue[axis];
+        endpoints[proxy.maxIndex[axis]].value = proxy.maxValue[axis];
+
+        // Grow first, then shrink, so endpoints of this proxy never cross each other
+        if (proxy.minValue[axis] < oldMin[axis]) SortMinDown(axis, proxy.minIndex[axis]);
+        if (proxy.maxValue[axis] > oldMax[axis]) SortMaxUp(axis, proxy.maxIndex[axis]);
+        if (proxy.minValue[axis] > oldMin[axis]) SortMinUp(axis, proxy.minIndex[axis]);
+        if (proxy.maxValue[axis] < oldMax[axis]) SortMaxDown(axis, proxy.maxIndex[axis]);
+    }
+}
+
+void DD_SweepAndPrune::ComputePairs(std::vector<BroadphasePair>& outPairs)
+{
+    outPairs.clear();
+    outPairs.reserve(m_pairCache.size());
+    for (uint64_t key : m_pairCache)
+    {
+        int a = static_cast<int>(key >> 32);
+        int b = static_cast<int>(key & 0xffffffffu);
+        // The cache is conservative for boxes that end up exactly touching
+        if (TestOverlap(a, b)) outPairs.push_back({ a, b });
+    }
+    std::sort(outPairs.begin(), outPairs.end());
+}
+
+void DD_SweepAndPrune::Query(const AABB& bounds, std::vector<int>& outProxies) const
+{
+    float queryMin[3], queryMax[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        queryMin[axis] = bounds.center[axis] - bounds.halfExtents[axis];
+        queryMax[axis] = bounds.center[axis] + bounds.halfExtents[axis];
+    }
+
+    // Every overlapping proxy has its x min endpoint before queryMax.x
+    const std::vector<Endpoint>& endpoints = m_endpoints[0];
+    for (const Endpoint& ep : endpoints)
+    {
+        if (ep.value >= queryMax[0]) break;
+        if (ep.IsMax()) continue;
+
+        const Proxy& proxy = m_proxies[ep.GetProxy()];
+        bool overlap = true;
+        for (int axis = 0; axis < 3 && overlap; ++axis)
+        {
+            overlap = proxy.maxValue[axis] > queryMin[axis] && proxy.minValue[axis] < queryMax[axis];
+        }
+        if (overlap) outProxies.push_back(ep.GetProxy());
+    }
+}
+
+bool DD_SweepAndPrune::TestOverlap(int a, int b) const
+{
+    const Proxy& pa = m_proxies[a];
+    const Proxy& pb = m_proxies[b];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (pa.maxValue[axis] <= pb.minValue[axis] || pb.maxValue[axis] <= pa.minValue[axis])
+            return false;
+    }
+    return true;
+}
+
+void DD_SweepAndPrune::AddPair(int a, int b)
+{
+    if (PassesFilter(a, b) && TestOverlap(a, b)) m_pairCache.insert(PairKey(a, b));
+}
+
+void DD_SweepAndPrune::RemovePair(int a, int b)
+{
+    m_pairCache.erase(PairKey(a, b));
+}
+
+void DD_SweepAndPrune::SetEndpointIndex(int axis, uint32_t index)
+{
+    const Endpoint& ep = m_endpoints[axis][index];
+    Proxy& proxy = m_proxies[ep.GetProxy()];
+    if (ep.IsMax()) proxy.maxIndex[axis] = index;
+    else proxy.minIndex[axis] = index;
+}
+
+// Min endpoint moving left past a max endpoint: the intervals start overlapping
+void DD_SweepAndPrune::SortMinDown(int axis, uint32_t index)
+{
+    std::vector<Endpoint>& endpoints = m_endpoints[axis];
+    Endpoint ep = endpoints[index];
+    while (index > 0 && endpoints[index - 1].value > ep.value)
+    {
+        const Endpoint& prev = endpoints[index - 1];
+        if (prev.IsMax()) AddPair(ep.GetProxy(), prev.GetProxy());
+
+        endpoints[index] = prev;
+        SetEndpointIndex(axis, index);
+        --index;
+    }
+    endpoints[index] = ep;
+    SetEndpointIndex(axis, index);
+}
+
+// Min endpoint moving right past a max endpoint: the intervals stop overlapping
+void DD_SweepAndPrune::SortMinUp(int axis, uint32_t index)
+{
+    std::vector<Endpoint>& endpoints = m_endpoints[axis];
+    const uint32_t last = static_cast<uint32_t>(endpoints.size()) - 1;
+    Endpoint ep = endpoints[index];
+    while (index < last && endpoints[index + 1].value < ep.value)
+    {
+        const Endpoint& next = endpoints[index + 1];
+        if (next.IsMax()) RemovePair(ep.GetProxy(), next.GetProxy());
+
+        endpoints[index] = next;
+        SetEndpointIndex(axis, index);
+        ++index;
+    }
+    endpoints[index] = ep;
+    SetEndpointIndex(axis, index);
+}
+
+// Max endpoint moving left past a min endpoint: the intervals stop overlapping
+void DD_SweepAndPrune::SortMaxDown(int axis, uint32_t index)
+{
+    std::vector<Endpoint>& endpoints = m_endpoints[axis];
+    Endpoint ep = endpoints[index];
+    while (index > 0 && endpoints[index - 1].value > ep.value)
+    {
+        const Endpoint& prev = endpoints[index - 1];
+        if (!prev.IsMax()) RemovePair(ep.GetProxy(), prev.GetProxy());
+
+        endpoints[index] = prev;
+        SetEndpointIndex(axis, index);
+        --index;
+    }
+    endpoints[index] = ep;
+    SetEndpointIndex(axis, index);
+}
+
+// Max endpoint moving right past a min endpoint: the intervals start overlapping
+void DD_SweepAndPrune::SortMaxUp(int axis, uint32_t index)
+{
+    std::vector<Endpoint>& endpoints = m_endpoints[axis];
+    const uint32_t last = static_cast<uint32_t>(endpoints.size()) - 1;
+    Endpoint ep = endpoints[index];
+    while (index < last && endpoints[index + 1].value < ep.value)
+    {
+        const Endpoint& next = endpoints[index + 1];
+        if (!next.IsMax()) AddPair(ep.GetProxy(), next.GetProxy());
+
+        endpoints[index] = next;
+        SetEndpointIndex(axis, index);
+        ++index;
+    }
+    endpoints[index] = ep;
+    SetEndpointIndex(axis, index);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "DD_Broadphase.h"
+#include <unordered_set>
+
+// Incremental 3-axis sweep-and-prune.
+// Endpoints stay sorted between frames; moving a proxy insertion-sorts only its own
+// endpoints, and overlap changes found during the swaps update a persistent pair cache.
+class DD_SweepAndPrune : public DD_Broadphase
+{
+public:
+    DD_SweepAndPrune();
+    virtual ~DD_SweepAndPrune();
+
+    virtual BroadphaseType GetType() const override { return BroadphaseType::SweepAndPrune; }
+
+    virtual int CreateProxy(const AABB& bounds, void* userData, const CollisionFilter& filter) override;
+    virtual void DestroyProxy(int proxyId) override;
+    virtual void MoveProxy(int proxyId, const AABB& bounds) override;
+    virtual void ComputePairs(std::vector<BroadphasePair>& outPairs) override;
+    virtual void Query(const AABB& bounds, std::vector<int>& outProxies) const override;
+
+    virtual void* GetUserData(int proxyId) const override { return m_proxies[proxyId].userData; }
+    virtual int GetProxyCount() const override { return m_proxyCount; }
+
+    size_t GetCachedPairCount() const { return m_pairCache.size(); }
+
+private:
+    struct Endpoint
+    {
+        float value;
+        uint32_t data;  // (proxyId << 1) | isMax
+
+        int GetProxy() const { return static_cast<int>(data >> 1); }
+        bool IsMax() const { return (data & 1u) != 0; }
+    };
+
+    struct Proxy
+    {
+        float minValue[3];
+        float maxValue[3];
+        uint32_t minIndex[3];
+        uint32_t maxIndex[3];
+        void* userData = nullptr;
+        bool active = false;
+    };
+
+    static void SetBounds(Proxy& proxy, const AABB& bounds);
+    bool TestOverlap(int a, int b) const;
+    void AddPair(int a, int b);
+    void RemovePair(int a, int b);
+    void SetEndpointIndex(int axis, uint32_t index);
+
+    void SortMinDown(int axis, uint32_t index);
+    void SortMinUp(int axis, uint32_t index);
+    void SortMaxDown(int axis, uint32_t index);
+    void SortMaxUp(int axis, uint32_t index);
+
+    static uint64_t PairKey(int a, int b)
+    {
+        if (a > b) { int t = a; a = b; b = t; }
+        return (static_cast<uint64_t>(a) << 32) | static_cast<uint32_t>(b);
+    }
+
+private:
+    std::vector<Endpoint> m_endpoints[3];
+    std::vector<Proxy> m_proxies;
+    std::vector<int> m_freeProxies;
+    std::unordered_set<uint64_t> m_pairCache;
+    int m_proxyCount;
+};
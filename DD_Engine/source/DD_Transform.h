@@ -6,21 +6,23 @@
 struct Transform
 {
     Vec3 position;
-	Vec3 rotation; // Euler angles in radians
+    Quaternion rotation; // Unit quaternion; Euler angles are derived on request
     Vec3 scale;
 
     Transform()
-        : position(0.0f), rotation(0.0f), scale(1.0f) {}
+        : position(0.0f), rotation(1.0f, 0.0f, 0.0f, 0.0f), scale(1.0f) {}
 };
 
 // Quaternion is now defined in DD_GLHelper.h
 
+// T * R * S written out directly: rotation columns scaled, translation in the last column
 inline Matrix4 BuildModelMatrix(const Transform& t)
 {
-    Matrix4 model = glm::translate(Matrix4(1.0f), t.position);
-    Quaternion q = glm::quat(t.rotation);
-    model *= glm::toMat4(q);
-    model = glm::scale(model, t.scale);
+    Matrix4 model = glm::toMat4(t.rotation);
+    model[0] *= t.scale.x;
+    model[1] *= t.scale.y;
+    model[2] *= t.scale.z;
+    model[3] = Vec4(t.position, 1.0f);
     return model;
 }
 
@@ -36,32 +38,39 @@ inline Vec3 EulerFromQuat(const Quaternion& q)
 
 inline Quaternion GetQuat(const Transform& t)
 {
-    return QuatFromEuler(t.rotation);
+    return t.rotation;
 }
 
 inline void SetQuat(Transform& t, const Quaternion& q)
 {
-    t.rotation = EulerFromQuat(q);
+    t.rotation = glm::normalize(q);
+}
+
+// Euler view of the rotation (radians). Not unique, so a set/get round trip may
+// return different but equivalent angles.
+inline Vec3 GetEuler(const Transform& t)
+{
+    return EulerFromQuat(t.rotation);
+}
+
+inline void SetEuler(Transform& t, const Vec3& eulerRadians)
+{
+    t.rotation = QuatFromEuler(eulerRadians);
 }
 
 inline void Translate(Transform& t, const Vec3& delta) { t.position += delta; }
 
-// Rotate by Euler angles (radians) - apply as q = q_delta * q_current
+// Rotate by Euler angles (radians) - apply as q = q_delta * q_current.
+// Renormalized so repeated small rotations do not drift.
 inline void Rotate(Transform& t, const Vec3& eulerDelta)
 {
-    Quaternion q = GetQuat(t);
-    Quaternion dq = QuatFromEuler(eulerDelta);
-    Quaternion r = dq * q;
-    SetQuat(t, r);
+    t.rotation = glm::normalize(QuatFromEuler(eulerDelta) * t.rotation);
 }
 
 // Rotate by axis-angle (angle in radians)
 inline void RotateAxis(Transform& t, float angleRadians, const Vec3& axis)
 {
-    Quaternion q = GetQuat(t);
-    Quaternion dq = glm::angleAxis(angleRadians, glm::normalize(axis));
-    Quaternion r = dq * q;
-    SetQuat(t, r);
+    t.rotation = glm::normalize(glm::angleAxis(angleRadians, glm::normalize(axis)) * t.rotation);
 }
 
 // Set scale
@@ -0,0 +1,175 @@
+#include "DD_TransformHierarchy.h"
+#include "DD_Actor.h"
+#include "DD_World.h"
+#include <algorithm>
+
+constexpr int DD_TransformHierarchy::NullNode;
+
+DD_TransformHierarchy::DD_TransformHierarchy()
+    : m_orderDirty(false)
+{
+}
+
+DD_TransformHierarchy::~DD_TransformHierarchy()
+{
+}
+
+int DD_TransformHierarchy::Add(DD_Actor* actor)
+{
+    if (actor->m_hierarchy) return actor->m_hierarchyNode;
+
+    int node;
+    if (!m_freeIds.empty())
+    {
+        node = m_freeIds.back();
+        m_freeIds.pop_back();
+    }
+    else
+    {
+        node = static_cast<int>(m_slotOf.size());
+        m_slotOf.push_back(-1);
+        m_parentOf.push_back(NullNode);
+        m_childCount.push_back(0);
+    }
+
+    // Roots can go at the end without breaking the parent-first order
+    m_slotOf[node] = static_cast<int>(m_slotNode.size());
+    m_parentOf[node] = NullNode;
+    m_slotNode.push_back(node);
+    m_slotParent.push_back(-1);
+    m_slotActors.push_back(actor);
+    m_world.push_back(Matrix4(1.0f));
+    m_dirty.push_back(1);
+
+    actor->m_hierarchy = this;
+    actor->m_hierarchyNode = node;
+    return node;
+}
+
+void DD_TransformHierarchy::Remove(int node)
+{
+    if (node < 0 || node >= static_cast<int>(m_slotOf.size()) || m_slotOf[node] < 0) return;
+
+    const bool hadChildren = m_childCount[node] > 0;
+    for (size_t slot = 0; slot < m_slotNode.size() && m_childCount[node] > 0; ++slot)
+    {
+        int child = m_slotNode[slot];
+        if (m_parentOf[child] != node) continue;
+        m_parentOf[child] = NullNode;
+        m_slotActors[slot]->m_parent = nullptr;
+        m_dirty[slot] = 1;
+        --m_childCount[node];
+    }
+    if (m_parentOf[node] != NullNode) --m_childCount[m_parentOf[node]];
+
+    // Swap-remove breaks the order, so the arrays are re-sorted on the next update
+    const int slot = m_slotOf[node];
+    DD_Actor* removed = m_slotActors[slot];
+    removed->m_hierarchy = nullptr;
+    removed->m_hierarchyNode = NullNode;
+    removed->m_parent = nullptr;
+    const int last = static_cast<int>(m_slotNode.size()) - 1;
+    if (slot != last)
+    {
+        m_slotNode[slot] = m_slotNode[last];
+        m_slotActors[slot] = m_slotActors[last];
+        m_world[slot] = m_world[last];
+        m_dirty[slot] = m_dirty[last];
+        m_slotOf[m_slotNode[slot]] = slot;
+    }
+    m_slotNode.pop_back();
+    m_slotParent.pop_back();
+    m_slotActors.pop_back();
+    m_world.pop_back();
+    m_dirty.pop_back();
+
+    m_slotOf[node] = -1;
+    m_parentOf[node] = NullNode;
+    m_freeIds.push_back(node);
+
+    // Removing the last slot of a leaf keeps the order and every parent slot valid
+    if (slot != last || hadChildren) m_orderDirty = true;
+}
+
+bool DD_TransformHierarchy::SetParent(int node, int parent)
+{
+    for (int ancestor = parent; ancestor != NullNode; ancestor = m_parentOf[ancestor])
+    {
+        if (ancestor == node) return false;
+    }
+
+    if (m_parentOf[node] != NullNode) --m_childCount[m_parentOf[node]];
+    if (parent != NullNode) ++m_childCount[parent];
+    m_parentOf[node] = parent;
+    m_slotActors[m_slotOf[node]]->m_parent = parent == NullNode ? nullptr : m_slotActors[m_slotOf[parent]];
+    m_dirty[m_slotOf[node]] = 1;
+    m_orderDirty = true;
+    return true;
+}
+
+// Stable sort of the slots by depth, so siblings keep their relative order
+void DD_TransformHierarchy::SortByDepth()
+{
+    const int count = static_cast<int>(m_slotNode.size());
+    std::vector<int> depth(count);
+    int maxDepth = 0;
+    for (int slot = 0; slot < count; ++slot)
+    {
+        int d = 0;
+        for (int p = m_parentOf[m_slotNode[slot]]; p != NullNode; p = m_parentOf[p]) ++d;
+        depth[slot] = d;
+        maxDepth = std::max(maxDepth, d);
+    }
+
+    std::vector<int> order(count);
+    std::vector<int> start(maxDepth + 2, 0);
+    for (int slot = 0; slot < count; ++slot) ++start[depth[slot] + 1];
+    for (int d = 1; d <= maxDepth + 1; ++d) start[d] += start[d - 1];
+    for (int slot = 0; slot < count; ++slot) order[start[depth[slot]]++] = slot;
+
+    std::vector<int> nodes(count);
+    std::vector<DD_Actor*> actors(count);
+    std::vector<Matrix4> world(count);
+    for (int i = 0; i < count; ++i)
+    {
+        nodes[i] = m_slotNode[order[i]];
+        actors[i] = m_slotActors[order[i]];
+        world[i] = m_world[order[i]];
+        m_slotOf[nodes[i]] = i;
+    }
+    m_slotNode.swap(nodes);
+    m_slotActors.swap(actors);
+    m_world.swap(world);
+
+    for (int slot = 0; slot < count; ++slot)
+    {
+        int parent = m_parentOf[m_slotNode[slot]];
+        m_slotParent[slot] = parent == NullNode ? -1 : m_slotOf[parent];
+    }
+
+    // Cheaper than remapping the flags, and structural changes are rare
+    std::fill(m_dirty.begin(), m_dirty.end(), 1);
+    m_orderDirty = false;
+}
+
+void DD_TransformHierarchy::Update(TransformStats& stats)
+{
+    if (m_orderDirty) SortByDepth();
+
+    const int count = static_cast<int>(m_slotNode.size());
+    for (int slot = 0; slot < count; ++slot)
+    {
+        const int parent = m_slotParent[slot];
+        if (parent >= 0 && m_dirty[parent]) m_dirty[slot] = 1;
+        if (!m_dirty[slot])
+        {
+            ++stats.matricesReused;
+            continue;
+        }
+
+        const Matrix4& local = m_slotActors[slot]->GetLocalMatrix();
+        m_world[slot] = parent >= 0 ? m_world[parent] * local : local;
+        ++stats.matricesRebuilt;
+    }
+    std::fill(m_dirty.begin(), m_dirty.end(), 0);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "DD_GLHelper.h"
+#include <cstdint>
+#include <vector>
+
+class DD_Actor;
+struct TransformStats;
+
+// Parent/child links between actors with world matrices kept in depth-sorted arrays.
+// Parents always sit before their children, so one linear pass computes every world
+// matrix and carries a parent's dirty flag down to its subtree without recursion.
+// Nodes are addressed by stable ids; the storage slot of a node changes when the
+// structure changes and the arrays are re-sorted.
+class DD_TransformHierarchy
+{
+public:
+    static constexpr int NullNode = -1;
+
+    DD_TransformHierarchy();
+    ~DD_TransformHierarchy();
+
+    // Adds the actor as a root node and returns its id (the existing id if already added)
+    int Add(DD_Actor* actor);
+    // Children of a removed node become roots
+    void Remove(int node);
+
+    // NullNode detaches. Returns false if parent is the node itself or one of its descendants.
+    bool SetParent(int node, int parent);
+    int GetParent(int node) const { return m_parentOf[node]; }
+
+    // Only flags the node; descendants are picked up by the next Update
+    void MarkDirty(int node) { m_dirty[m_slotOf[node]] = 1; }
+
+    // Recomputes the world matrices of dirty nodes and their descendants
+    void Update(TransformStats& stats);
+
+    // Valid after the Update following the last change
+    const Matrix4& GetWorldMatrix(int node) const { return m_world[m_slotOf[node]]; }
+
+    int GetNodeCount() const { return static_cast<int>(m_slotActors.size()); }
+
+private:
+    void SortByDepth();
+
+private:
+    // Per node id
+    std::vector<int> m_slotOf;     // -1 for free ids
+    std::vector<int> m_parentOf;   // Parent node id
+    std::vector<int> m_childCount; // Lets Remove skip the child scan for leaves
+    std::vector<int> m_freeIds;
+
+    // Per storage slot, parents before children
+    std::vector<int> m_slotNode;
+    std::vector<int> m_slotParent; // Parent slot, -1 for roots
+    std::vector<DD_Actor*> m_slotActors;
+    std::vector<Matrix4> m_world;
+    std::vector<uint8_t> m_dirty;
+
+    bool m_orderDirty;
+};
@@ -0,0 +1,272 @@
+#include "DD_TransformStorage.h"
+#include "DD_Actor.h"
+#include "DD_TransformHierarchy.h"
+#include "DD_SIMD.h"
+#include <cmath>
+
+using Simd::BatchFloat;
+using Simd::kBatchLanes;
+using Simd::BatchLoad;
+using Simd::BatchSplat;
+
+void DD_TransformStorage::Bind(DD_Actor* owner)
+{
+    if (owner->m_transforms) return;
+
+    const int index = static_cast<int>(m_owners.size());
+    m_posX.push_back(0.0f); m_posY.push_back(0.0f); m_posZ.push_back(0.0f);
+    m_rotX.push_back(0.0f); m_rotY.push_back(0.0f); m_rotZ.push_back(0.0f); m_rotW.push_back(1.0f);
+    m_scaleX.push_back(1.0f); m_scaleY.push_back(1.0f); m_scaleZ.push_back(1.0f);
+    m_prevPosX.push_back(0.0f); m_prevPosY.push_back(0.0f); m_prevPosZ.push_back(0.0f);
+    m_prevRotX.push_back(0.0f); m_prevRotY.push_back(0.0f); m_prevRotZ.push_back(0.0f); m_prevRotW.push_back(1.0f);
+    m_prevScaleX.push_back(1.0f); m_prevScaleY.push_back(1.0f); m_prevScaleZ.push_back(1.0f);
+    m_moved.push_back(NoPrevious);
+    m_local.push_back(Matrix4(1.0f));
+    m_dirty.push_back(0);
+    m_owners.push_back(owner);
+
+    owner->m_transforms = this;
+    owner->m_transformIndex = index;
+    SetTransform(index, owner->m_standalone);
+    MarkDirty(index);
+}
+
+void DD_TransformStorage::Free(int index)
+{
+    if (index < 0 || index >= GetCount()) return;
+
+    const int last = GetCount() - 1;
+    if (index != last)
+    {
+        m_posX[index] = m_posX[last]; m_posY[index] = m_posY[last]; m_posZ[index] = m_posZ[last];
+        m_rotX[index] = m_rotX[last]; m_rotY[index] = m_rotY[last]; m_rotZ[index] = m_rotZ[last]; m_rotW[index] = m_rotW[last];
+        m_scaleX[index] = m_scaleX[last]; m_scaleY[index] = m_scaleY[last]; m_scaleZ[index] = m_scaleZ[last];
+        m_prevPosX[index] = m_prevPosX[last]; m_prevPosY[index] = m_prevPosY[last]; m_prevPosZ[index] = m_prevPosZ[last];
+        m_prevRotX[index] = m_prevRotX[last]; m_prevRotY[index] = m_prevRotY[last]; m_prevRotZ[index] = m_prevRotZ[last]; m_prevRotW[index] = m_prevRotW[last];
+        m_prevScaleX[index] = m_prevScaleX[last]; m_prevScaleY[index] = m_prevScaleY[last]; m_prevScaleZ[index] = m_prevScaleZ[last];
+        m_moved[index] = m_moved[last];
+        m_local[index] = m_local[last];
+        m_dirty[index] = m_dirty[last];
+        m_owners[index] = m_owners[last];
+        m_owners[index]->m_transformIndex = index;
+    }
+
+    m_posX.pop_back(); m_posY.pop_back(); m_posZ.pop_back();
+    m_rotX.pop_back(); m_rotY.pop_back(); m_rotZ.pop_back(); m_rotW.pop_back();
+    m_scaleX.pop_back(); m_scaleY.pop_back(); m_scaleZ.pop_back();
+    m_prevPosX.pop_back(); m_prevPosY.pop_back(); m_prevPosZ.pop_back();
+    m_prevRotX.pop_back(); m_prevRotY.pop_back(); m_prevRotZ.pop_back(); m_prevRotW.pop_back();
+    m_prevScaleX.pop_back(); m_prevScaleY.pop_back(); m_prevScaleZ.pop_back();
+    m_moved.pop_back();
+    m_local.pop_back();
+    m_dirty.pop_back();
+    m_owners.pop_back();
+}
+
+void DD_TransformStorage::NotifyOwner(int index)
+{
+    m_owners[index]->OnTransformChanged();
+}
+
+void DD_TransformStorage::MarkRecompose(int index)
+{
+    m_dirty[index] = 1;
+    const DD_Actor* owner = m_owners[index];
+    if (owner->m_hierarchy) owner->m_hierarchy->MarkDirty(owner->m_hierarchyNode);
+}
+
+void DD_TransformStorage::BeginStep()
+{
+    // Slots that moved during the last step may hold blended matrices; the blend collapses
+    // to the current state now that previous and current are equal
+    const int count = GetCount();
+    for (int i = 0; i < count; ++i)
+    {
+        if (m_moved[i] == 0) continue;
+        m_moved[i] = 0;
+        MarkRecompose(i);
+    }
+
+    m_prevPosX = m_posX; m_prevPosY = m_posY; m_prevPosZ = m_posZ;
+    m_prevRotX = m_rotX; m_prevRotY = m_rotY; m_prevRotZ = m_rotZ; m_prevRotW = m_rotW;
+    m_prevScaleX = m_scaleX; m_prevScaleY = m_scaleY; m_prevScaleZ = m_scaleZ;
+    m_previousAligned = false;
+}
+
+void DD_TransformStorage::SetInterpolation(float alpha)
+{
+    alpha = alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+    const bool changed = alpha != m_alpha;
+    m_alpha = alpha;
+    if (m_previousAligned && !changed) return;
+
+    const int count = GetCount();
+    for (int i = 0; i < count; ++i)
+    {
+        if (m_moved[i] == 0) continue;
+
+        if (!m_previousAligned)
+        {
+            if (m_moved[i] & NoPrevious)
+            {
+                m_prevPosX[i] = m_posX[i]; m_prevPosY[i] = m_posY[i]; m_prevPosZ[i] = m_posZ[i];
+                m_prevRotX[i] = m_rotX[i]; m_prevRotY[i] = m_rotY[i]; m_prevRotZ[i] = m_rotZ[i]; m_prevRotW[i] = m_rotW[i];
+                m_prevScaleX[i] = m_scaleX[i]; m_prevScaleY[i] = m_scaleY[i]; m_prevScaleZ[i] = m_scaleZ[i];
+            }
+            // q and -q are the same rotation; blend along the shorter arc
+            const float dot = m_prevRotX[i] * m_rotX[i] + m_prevRotY[i] * m_rotY[i] + m_prevRotZ[i] * m_rotZ[i] + m_prevRotW[i] * m_rotW[i];
+            if (dot < 0.0f)
+            {
+                m_prevRotX[i] = -m_prevRotX[i]; m_prevRotY[i] = -m_prevRotY[i];
+                m_prevRotZ[i] = -m_prevRotZ[i]; m_prevRotW[i] = -m_prevRotW[i];
+            }
+        }
+        MarkRecompose(i);
+    }
+    m_previousAligned = true;
+}
+
+Transform DD_TransformStorage::GetTransform(int index) const
+{
+    Transform t;
+    t.position = GetPosition(index);
+    t.rotation = GetRotation(index);
+    t.scale = GetScale(index);
+    return t;
+}
+
+void DD_TransformStorage::SetTransform(int index, const Transform& t)
+{
+    SetPosition(index, t.position);
+    SetRotation(index, t.rotation);
+    SetScale(index, t.scale);
+}
+
+const Matrix4& DD_TransformStorage::GetLocalMatrix(int index)
+{
+    if (m_dirty[index]) ComposeScalar(index);
+    return m_local[index];
+}
+
+// Position and scale lerp, rotation nlerp; the same arithmetic as ComposeBatch
+Transform DD_TransformStorage::GetBlendedTransform(int index) const
+{
+    if (m_alpha >= 1.0f) return GetTransform(index);
+
+    const float a = m_alpha;
+    auto blend = [a](float prev, float cur) { return (cur - prev) * a + prev; };
+
+    Transform t;
+    t.position = Vec3(blend(m_prevPosX[index], m_posX[index]), blend(m_prevPosY[index], m_posY[index]), blend(m_prevPosZ[index], m_posZ[index]));
+    t.scale = Vec3(blend(m_prevScaleX[index], m_scaleX[index]), blend(m_prevScaleY[index], m_scaleY[index]), blend(m_prevScaleZ[index], m_scaleZ[index]));
+
+    const float x = blend(m_prevRotX[index], m_rotX[index]);
+    const float y = blend(m_prevRotY[index], m_rotY[index]);
+    const float z = blend(m_prevRotZ[index], m_rotZ[index]);
+    const float w = blend(m_prevRotW[index], m_rotW[index]);
+    const float invLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+    t.rotation = Quaternion(w * invLength, x * invLength, y * invLength, z * invLength);
+    return t;
+}
+
+void DD_TransformStorage::ComposeScalar(int index)
+{
+    m_local[index] = BuildModelMatrix(GetBlendedTransform(index));
+    m_dirty[index] = 0;
+}
+
+// Same expansion as glm::toMat4 followed by the column scale in BuildModelMatrix
+void DD_TransformStorage::ComposeBatch(int first)
+{
+    const BatchFloat one = BatchSplat(1.0f);
+    const BatchFloat two = BatchSplat(2.0f);
+
+    // Blended lanes of slots that did not move come out unchanged, since previous == current
+    const bool blend = m_alpha < 1.0f;
+    const BatchFloat alpha = BatchSplat(m_alpha);
+    auto load = [&](const std::vector<float>& prev, const std::vector<float>& cur)
+    {
+        const BatchFloat c = BatchLoad(&cur[first]);
+        if (!blend) return c;
+        const BatchFloat p = BatchLoad(&prev[first]);
+        return Simd::MulAdd(Simd::Sub(c, p), alpha, p);
+    };
+
+    BatchFloat x = load(m_prevRotX, m_rotX);
+    BatchFloat y = load(m_prevRotY, m_rotY);
+    BatchFloat z = load(m_prevRotZ, m_rotZ);
+    BatchFloat w = load(m_prevRotW, m_rotW);
+    if (blend)
+    {
+        const BatchFloat lengthSq = Simd::Add(Simd::Add(Simd::Mul(x, x), Simd::Mul(y, y)), Simd::Add(Simd::Mul(z, z), Simd::Mul(w, w)));
+        const BatchFloat invLength = Simd::Div(one, Simd::Sqrt(lengthSq));
+        x = Simd::Mul(x, invLength);
+        y = Simd::Mul(y, invLength);
+        z = Simd::Mul(z, invLength);
+        w = Simd::Mul(w, invLength);
+    }
+
+    const BatchFloat xx = Simd::Mul(x, x), yy = Simd::Mul(y, y), zz = Simd::Mul(z, z);
+    const BatchFloat xy = Simd::Mul(x, y), xz = Simd::Mul(x, z), yz = Simd::Mul(y, z);
+    const BatchFloat wx = Simd::Mul(w, x), wy = Simd::Mul(w, y), wz = Simd::Mul(w, z);
+
+    const BatchFloat sx = load(m_prevScaleX, m_scaleX);
+    const BatchFloat sy = load(m_prevScaleY, m_scaleY);
+    const BatchFloat sz = load(m_prevScaleZ, m_scaleZ);
+
+    // m[column][row] for the 3x3 part, one value per lane
+    float m[9][kBatchLanes];
+    Simd::Store(m[0], Simd::Mul(Simd::Sub(one, Simd::Mul(two, Simd::Add(yy, zz))), sx));
+    Simd::Store(m[1], Simd::Mul(Simd::Mul(two, Simd::Add(xy, wz)), sx));
+    Simd::Store(m[2], Simd::Mul(Simd::Mul(two, Simd::Sub(xz, wy)), sx));
+    Simd::Store(m[3], Simd::Mul(Simd::Mul(two, Simd::Sub(xy, wz)), sy));
+    Simd::Store(m[4], Simd::Mul(Simd::Sub(one, Simd::Mul(two, Simd::Add(xx, zz))), sy));
+    Simd::Store(m[5], Simd::Mul(Simd::Mul(two, Simd::Add(yz, wx)), sy));
+    Simd::Store(m[6], Simd::Mul(Simd::Mul(two, Simd::Add(xz, wy)), sz));
+    Simd::Store(m[7], Simd::Mul(Simd::Mul(two, Simd::Sub(yz, wx)), sz));
+    Simd::Store(m[8], Simd::Mul(Simd::Sub(one, Simd::Mul(two, Simd::Add(xx, yy))), sz));
+
+    float px[kBatchLanes], py[kBatchLanes], pz[kBatchLanes];
+    Simd::Store(px, load(m_prevPosX, m_posX));
+    Simd::Store(py, load(m_prevPosY, m_posY));
+    Simd::Store(pz, load(m_prevPosZ, m_posZ));
+
+    for (int lane = 0; lane < kBatchLanes; ++lane)
+    {
+        const int index = first + lane;
+        Matrix4& out = m_local[index];
+        for (int column = 0; column < 3; ++column)
+        {
+            out[column] = Vec4(m[column * 3][lane], m[column * 3 + 1][lane], m[column * 3 + 2][lane], 0.0f);
+        }
+        out[3] = Vec4(px[lane], py[lane], pz[lane], 1.0f);
+        m_dirty[index] = 0;
+    }
+}
+
+int DD_TransformStorage::UpdateLocalMatrices()
+{
+    const int count = GetCount();
+    int composed = 0;
+
+    // A group with any dirty slot is composed whole; rewriting a clean lane is cheaper
+    // than branching per lane
+    int first = 0;
+    for (; first + kBatchLanes <= count; first += kBatchLanes)
+    {
+        bool dirty = false;
+        for (int lane = 0; lane < kBatchLanes; ++lane) dirty |= m_dirty[first + lane] != 0;
+        if (!dirty) continue;
+
+        ComposeBatch(first);
+        composed += kBatchLanes;
+    }
+
+    for (; first < count; ++first)
+    {
+        if (!m_dirty[first]) continue;
+        ComposeScalar(first);
+        ++composed;
+    }
+    return composed;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "DD_GLHelper.h"
+#include "DD_Transform.h"
+#include <cstdint>
+#include <vector>
+
+class DD_Actor;
+
+// Transforms of a world's actors in structure-of-arrays layout. Each world owns one,
+// so stepping and interpolating one world never touches another's actors.
+// Each actor owns one slot and keeps its index; removal swaps the last slot in, so the
+// arrays stay dense and a pass over transforms touches only transform data.
+// Local TRS matrices are composed several slots at a time with SIMD.
+// Like the rest of a world, a storage is not synchronized: Bind and Free run on the
+// thread that adds and removes the world's actors.
+class DD_TransformStorage
+{
+public:
+    DD_TransformStorage() = default;
+    DD_TransformStorage(const DD_TransformStorage&) = delete;
+    DD_TransformStorage& operator=(const DD_TransformStorage&) = delete;
+
+    // Moves the actor's standalone transform into a new slot of this storage
+    void Bind(DD_Actor* actor);
+    // Moves the last slot into index and updates that slot's owner
+    void Free(int index);
+
+    Vec3 GetPosition(int index) const { return Vec3(m_posX[index], m_posY[index], m_posZ[index]); }
+    void SetPosition(int index, const Vec3& p) { m_posX[index] = p.x; m_posY[index] = p.y; m_posZ[index] = p.z; }
+
+    Quaternion GetRotation(int index) const { return Quaternion(m_rotW[index], m_rotX[index], m_rotY[index], m_rotZ[index]); }
+    void SetRotation(int index, const Quaternion& q) { m_rotX[index] = q.x; m_rotY[index] = q.y; m_rotZ[index] = q.z; m_rotW[index] = q.w; }
+
+    Vec3 GetScale(int index) const { return Vec3(m_scaleX[index], m_scaleY[index], m_scaleZ[index]); }
+    void SetScale(int index, const Vec3& s) { m_scaleX[index] = s.x; m_scaleY[index] = s.y; m_scaleZ[index] = s.z; }
+
+    Transform GetTransform(int index) const;
+    void SetTransform(int index, const Transform& t);
+
+    void MarkDirty(int index) { m_dirty[index] = 1; m_moved[index] |= MovedThisStep; }
+
+    // For systems that write the arrays directly: tells the owner its transform changed,
+    // as DD_Actor's setters do
+    void NotifyOwner(int index);
+
+    // Render interpolation between the last two simulation steps. BeginStep makes the
+    // current state the previous one; SetInterpolation makes the matrices composed next
+    // blend the slots changed since, from previous (0) to current (1). Matrices are then
+    // render state and trail the transforms by up to one step.
+    void BeginStep();
+    void SetInterpolation(float alpha);
+    float GetInterpolation() const { return m_alpha; }
+
+    // Composes the matrix on first use after a change
+    const Matrix4& GetLocalMatrix(int index);
+
+    // Recomposes every dirty local matrix, kBatchLanes slots per iteration.
+    // Returns the number of matrices written.
+    int UpdateLocalMatrices();
+
+    int GetCount() const { return static_cast<int>(m_owners.size()); }
+
+private:
+    enum : uint8_t
+    {
+        MovedThisStep = 1,
+        NoPrevious = 2  // Bound since BeginStep; snaps instead of blending from identity
+    };
+
+    // Dirties the slot here and in its owner's hierarchy, so the world matrix is rebuilt too
+    void MarkRecompose(int index);
+    Transform GetBlendedTransform(int index) const;
+    void ComposeScalar(int index);
+    void ComposeBatch(int first);
+
+private:
+    std::vector<float> m_posX, m_posY, m_posZ;
+    std::vector<float> m_rotX, m_rotY, m_rotZ, m_rotW;
+    std::vector<float> m_scaleX, m_scaleY, m_scaleZ;
+
+    // State at the last BeginStep
+    std::vector<float> m_prevPosX, m_prevPosY, m_prevPosZ;
+    std::vector<float> m_prevRotX, m_prevRotY, m_prevRotZ, m_prevRotW;
+    std::vector<float> m_prevScaleX, m_prevScaleY, m_prevScaleZ;
+    std::vector<uint8_t> m_moved;
+    float m_alpha = 1.0f;
+    bool m_previousAligned = false;  // Moved slots prepared for blending this step
+
+    std::vector<Matrix4> m_local;
+    std::vector<uint8_t> m_dirty;
+    std::vector<DD_Actor*> m_owners;
+};
@@ -1,12 +1,19 @@
 #include "DD_World.h"
 #include "DD_Core.h"
 #include "DD_Camera.h"
+#include "DD_CommandBuffer.h"
 #include "DD_SimpleBox.h"
 #include "DD_Actor.h"
 #include "DD_CollisionComponent.h"
 #include "DD_MeshComponent.h"
+#include "DD_Mesh.h"
+#include "DD_RigidBodyComponent.h"
 #include "DD_CollisionUtils.h"
+#include "DD_SweepAndPrune.h"
+#include "DD_SpatialHashGrid.h"
+#include "DD_AABBTreeBroadphase.h"
 #include "DD_DebugDraw.h"
+#include "DD_JobSystem.h"
 #include "DD_LightActor.h"
 #include "DD_LightComponent.h"
 #include "DD_ShadowRenderer.h"
@@ -15,7 +22,10 @@
 #include "DD_GLDevice.h"
 #include "DD_Material.h"
 #include "DD_Texture.h"
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <chrono>
 #include <glm/gtc/type_ptr.hpp>
 
 DD_World::DD_World()
@@ -30,7 +40,29 @@ DD_World::DD_World()
     , m_viewportWidth(1280)
     , m_viewportHeight(720)
     , m_simTime(0.0f)
+    , m_broadphaseType(BroadphaseType::BruteForce)
+    , m_spatialHashCellSize(4.0f)
+    , m_gravity(0.0f, -9.81f, 0.0f)
 {
+    static std::atomic<uint64_t> s_nextWorldSerial(1);
+    m_worldSerial = s_nextWorldSerial.fetch_add(1);
+
+    SetBroadphaseType(BroadphaseType::AABBTree);
+
+    // Pools move components when they grow or remove; keep the owners' pointers current
+    m_meshPool.SetRelocateCallback([this](uint32_t entity, DD_MeshComponent* mesh)
+    {
+        m_actorSlots[entity].actor->SetMeshComponent(mesh);
+    });
+    m_collisionPool.SetRelocateCallback([this](uint32_t entity, DD_CollisionComponent* col)
+    {
+        m_actorSlots[entity].actor->SetCollisionComponent(col);
+    });
+    m_bodyPool.SetRelocateCallback([this](uint32_t entity, DD_RigidBodyComponent* body)
+    {
+        DD_Actor* actor = m_actorSlots[entity].actor;
+        actor->RelocateComponent(actor->GetRigidBodyComponent(), body);
+    });
 }
 
 DD_World::~DD_World()
@@ -117,18 +149,16 @@ void DD_World::Init(int width, int height)
 
     // Ground
     {
-        auto comp = std::make_unique<DD_MeshComponent>();
-        comp->SetMesh(m_sharedMesh.get());
-        comp->SetMaterial(groundMat);
-        comp->SetCastShadow(false);
-        m_meshComponents.push_back(std::move(comp));
-
         auto actor = std::make_unique<DD_Actor>();
         actor->SetName("Ground");
-        actor->SetMeshComponent(m_meshComponents.back().get());
         actor->SetPosition(Vec3(0.0f, -1.5f, 0.0f));
         actor->SetScale(Vec3(30.0f, 0.2f, 30.0f));
-        m_actors.push_back(std::move(actor));
+        DD_Actor* ground = AdoptActor(std::move(actor));
+
+        DD_MeshComponent* comp = AddMeshComponent(ground);
+        comp->SetMesh(m_sharedMesh.get());
+        comp->SetMaterial(groundMat);
+        comp->SetCastShadow(false);
     }
 
     // Scene objects
@@ -144,32 +174,23 @@ void DD_World::Init(int width, int height)
         { Vec3(0.0f, 5.5f, -2.0f), Vec3(0.6f), goldMetal, "FloatingGold" },
     };
 
-    m_movers.resize(objects.size());
     for (size_t i = 0; i < objects.size(); ++i)
     {
         const auto& obj = objects[i];
-        auto meshComp = std::make_unique<DD_MeshComponent>();
-        meshComp->SetMesh(m_sharedMesh.get());
-        meshComp->SetMaterial(obj.mat);
-        m_meshComponents.push_back(std::move(meshComp));
-
         auto actor = std::make_unique<DD_Actor>();
         actor->SetName(obj.name);
-        actor->SetMeshComponent(m_meshComponents.back().get());
         actor->SetPosition(obj.pos);
         actor->SetScale(obj.scale);
 
+        DD_Actor* object = AdoptActor(std::move(actor));
         if (std::string(obj.name).find("Floating") != std::string::npos)
         {
-            auto& mv = m_movers[i];
-            mv.enabled = true;
-            mv.basePosition = obj.pos;
-            mv.amplitude = 0.5f;
-            mv.frequency = 0.8f + i * 0.1f;
-            mv.phase = i * 0.5f;
-            mv.axis = Vec3(0.0f, 1.0f, 0.0f);
+            m_movers.AddOscillator(object, Vec3(0.0f, 1.0f, 0.0f), 0.5f, 0.8f + i * 0.1f, i * 0.5f);
         }
-        m_actors.push_back(std::move(actor));
+
+        DD_MeshComponent* meshComp = AddMeshComponent(object);
+        meshComp->SetMesh(m_sharedMesh.get());
+        meshComp->SetMaterial(obj.mat);
     }
 
     // Add point lights around the scene
@@ -191,7 +212,7 @@ DD_LightActor* DD_World::CreateDirectionalLight()
     DD_LightActor* ptr = lightActor.get();
     m_lights.push_back(ptr);
     if (!m_mainLight) m_mainLight = ptr;
-    m_actors.push_back(std::move(lightActor));
+    AdoptActor(std::move(lightActor));
     return ptr;
 }
 
@@ -206,41 +227,212 @@ DD_LightActor* DD_World::CreatePointLight(const Vec3& position, const Vec3& colo
     lightActor->SetCastShadow(false);
     DD_LightActor* ptr = lightActor.get();
     m_lights.push_back(ptr);
-    m_actors.push_back(std::move(lightActor));
+    AdoptActor(std::move(lightActor));
+    return ptr;
+}
+
+ActorHandle DD_World::AddActor(std::unique_ptr<DD_Actor> actor)
+{
+    if (!actor || actor->GetEntityId() != DD_Actor::InvalidEntity) return ActorHandle();
+    return GetHandle(AdoptActor(std::move(actor)));
+}
+
+DD_Actor* DD_World::AdoptActor(std::unique_ptr<DD_Actor> actor)
+{
+    uint32_t entity;
+    if (!m_freeActorSlots.empty())
+    {
+        entity = m_freeActorSlots.back();
+        m_freeActorSlots.pop_back();
+    }
+    else
+    {
+        entity = static_cast<uint32_t>(m_actorSlots.size());
+        m_actorSlots.emplace_back();
+    }
+
+    DD_Actor* ptr = actor.get();
+    ActorSlot& slot = m_actorSlots[entity];
+    slot.actor = ptr;
+    slot.denseIndex = static_cast<uint32_t>(m_actors.size());
+    ptr->m_entityId = entity;
+
+    m_transforms.Bind(ptr);
+    m_transformHierarchy.Add(ptr);
+    m_actors.push_back(std::move(actor));
     return ptr;
 }
 
-void DD_World::AddActor(DD_Actor* actor) {}
+DD_Actor* DD_World::GetActor(ActorHandle handle) const
+{
+    if (handle.index >= m_actorSlots.size()) return nullptr;
+    const ActorSlot& slot = m_actorSlots[handle.index];
+    return slot.generation == handle.generation ? slot.actor : nullptr;
+}
+
+ActorHandle DD_World::GetHandle(const DD_Actor* actor) const
+{
+    ActorHandle handle;
+    if (!actor) return handle;
+    const uint32_t entity = actor->GetEntityId();
+    if (entity >= m_actorSlots.size() || m_actorSlots[entity].actor != actor) return handle;
+    handle.index = entity;
+    handle.generation = m_actorSlots[entity].generation;
+    return handle;
+}
+
+// Colliders and bodies are built from the local transform, so parented actors get none
+DD_RigidBodyComponent* DD_World::CreateRigidBody(DD_Actor* actor)
+{
+    if (actor->GetEntityId() == DD_Actor::InvalidEntity || actor->GetParent()) return nullptr;
+    DD_RigidBodyComponent* body = m_bodyPool.Add(actor->GetEntityId());
+    actor->SetRigidBodyComponent(body);
+    return body;
+}
+
+DD_MeshComponent* DD_World::AddMeshComponent(DD_Actor* actor)
+{
+    if (actor->GetEntityId() == DD_Actor::InvalidEntity) return nullptr;
+    DD_MeshComponent* mesh = m_meshPool.Add(actor->GetEntityId());
+    actor->SetMeshComponent(mesh);
+    return mesh;
+}
+
+DD_CollisionComponent* DD_World::AddCollisionComponent(DD_Actor* actor)
+{
+    if (actor->GetEntityId() == DD_Actor::InvalidEntity || actor->GetParent()) return nullptr;
+    DD_CollisionComponent* col = m_collisionPool.Add(actor->GetEntityId());
+    actor->SetCollisionComponent(col);
+    return col;
+}
+
+void DD_World::RemoveActor(ActorHandle handle)
+{
+    DD_Actor* actor = GetActor(handle);
+    if (actor) RemoveActor(actor);
+}
 
+// Destroys the actor; O(1) apart from light bookkeeping and children in the hierarchy
 void DD_World::RemoveActor(DD_Actor* actor)
 {
-    auto lightIt = std::find(m_lights.begin(), m_lights.end(), actor);
-    if (lightIt != m_lights.end())
+    if (!actor) return;
+    const uint32_t entity = actor->GetEntityId();
+    if (entity >= m_actorSlots.size() || m_actorSlots[entity].actor != actor) return;
+
+    DD_CollisionComponent* col = actor->GetCollisionComponent();
+    if (col && col->m_proxyId >= 0 && m_broadphase) DestroyProxy(col);
+
+    // Detach before the pools move other components into the freed slots
+    if (actor->GetRigidBodyComponent()) actor->SetRigidBodyComponent(nullptr);
+    if (m_meshPool.Has(entity)) actor->SetMeshComponent(nullptr);
+    if (m_collisionPool.Has(entity)) actor->SetCollisionComponent(nullptr);
+    m_movers.Remove(entity);
+    m_bodyPool.Remove(entity);
+    m_meshPool.Remove(entity);
+    m_collisionPool.Remove(entity);
+
+    // Children of the actor become roots
+    m_transformHierarchy.Remove(actor->GetHierarchyNode());
+
+    // Only light actors can be in m_lights, which stays small
+    if (actor->GetComponent<DD_LightComponent>())
     {
-        if (m_mainLight == *lightIt) m_mainLight = nullptr;
-        m_lights.erase(lightIt);
+        auto lightIt = std::find(m_lights.begin(), m_lights.end(), actor);
+        if (lightIt != m_lights.end())
+        {
+            if (m_mainLight == *lightIt) m_mainLight = nullptr;
+            m_lights.erase(lightIt);
+        }
     }
-    auto it = std::find_if(m_actors.begin(), m_actors.end(),
-        [actor](const std::unique_ptr<DD_Actor>& ptr) { return ptr.get() == actor; });
-    if (it != m_actors.end()) m_actors.erase(it);
+
+    // Retire the slot; the new generation makes existing handles stale
+    ActorSlot& slot = m_actorSlots[entity];
+    const uint32_t dense = slot.denseIndex;
+    slot.actor = nullptr;
+    ++slot.generation;
+    m_freeActorSlots.push_back(entity);
+    actor->m_entityId = DD_Actor::InvalidEntity;
+
+    // Move the last actor into the freed place; this destroys the removed actor
+    const uint32_t last = static_cast<uint32_t>(m_actors.size()) - 1;
+    if (dense != last)
+    {
+        m_actors[dense] = std::move(m_actors[last]);
+        m_actorSlots[m_actors[dense]->GetEntityId()].denseIndex = dense;
+    }
+    m_actors.pop_back();
 }
 
+// Actors per update chunk; small enough to balance, large enough to amortize a job
+static constexpr int kActorUpdateChunk = 32;
+
 void DD_World::Update(float deltaTime)
 {
     m_simTime += deltaTime;
-    for (auto& actorPtr : m_actors) actorPtr->Update(deltaTime);
 
-    size_t actorOffset = 2;  // Skip ground and light
-    for (size_t i = 0; i < m_movers.size(); ++i)
+    // Transforms as of the end of the previous step, the start point for interpolation
+    m_transforms.BeginStep();
+
+    // Local matrices compose lazily on read; compose the dirty ones now so actors reading
+    // each other's matrices in the parallel phase do not race on the cache
+    m_transforms.UpdateLocalMatrices();
+
+    // Parallel phase. Chunk boundaries depend only on the actor count, and each chunk runs
+    // its actors and their components in order on one thread.
+    const int actorCount = static_cast<int>(m_actors.size());
+    const int chunkCount = (actorCount + kActorUpdateChunk - 1) / kActorUpdateChunk;
+    auto updateChunks = [&](int firstChunk, int endChunk)
     {
-        size_t actorIdx = actorOffset + i;
-        if (actorIdx >= m_actors.size()) break;
-        auto& mv = m_movers[i];
-        if (!mv.enabled) continue;
-        float v = cosf(m_simTime * mv.frequency + mv.phase);
-        m_actors[actorIdx]->SetPosition(mv.basePosition + mv.axis * (mv.amplitude * v));
-    }
+        const int end = std::min(endChunk * kActorUpdateChunk, actorCount);
+        for (int i = firstChunk * kActorUpdateChunk; i < end; ++i) m_actors[i]->Update(deltaTime);
+    };
+    if (m_parallelUpdate) gJobSystem.ParallelFor(chunkCount, 1, updateChunks);
+    else updateChunks(0, chunkCount);
+
+    // Main thread phase, in actor order
+    for (auto& actorPtr : m_actors) actorPtr->MainThreadUpdate(deltaTime);
+
+    m_movers.Update(deltaTime);
     PostTick(deltaTime);
+
+    // Safe point: nothing iterates actors or pools until the next Update
+    FlushCommands();
+}
+
+DD_CommandBuffer& DD_World::GetCommandBuffer()
+{
+    // Fast path without the lock: this thread's buffer for the world it last recorded into
+    struct ThreadCache
+    {
+        uint64_t worldSerial = 0;
+        DD_CommandBuffer* buffer = nullptr;
+    };
+    static thread_local ThreadCache t_cache;
+    if (t_cache.worldSerial == m_worldSerial) return *t_cache.buffer;
+
+    std::lock_guard<std::mutex> lock(m_commandBufferMutex);
+    DD_CommandBuffer*& buffer = m_commandBufferByThread[std::this_thread::get_id()];
+    if (!buffer)
+    {
+        m_commandBuffers.push_back(std::make_unique<DD_CommandBuffer>());
+        buffer = m_commandBuffers.back().get();
+    }
+    t_cache.worldSerial = m_worldSerial;
+    t_cache.buffer = buffer;
+    return *buffer;
+}
+
+void DD_World::FlushCommands()
+{
+    m_appliedCommandCount = 0;
+    for (auto& buffer : m_commandBuffers) m_appliedCommandCount += buffer->GetCommandCount();
+    if (m_appliedCommandCount == 0) return;
+
+    // Phase by phase across buffers, so attachments see every spawn and destroys come last
+    for (auto& buffer : m_commandBuffers) buffer->ApplySpawns(*this);
+    for (auto& buffer : m_commandBuffers) buffer->ApplyAttachments(*this);
+    for (auto& buffer : m_commandBuffers) buffer->ApplyDestroys(*this);
+    for (auto& buffer : m_commandBuffers) buffer->Reset();
 }
 
 void DD_World::PostTick(float deltaTime)
@@ -264,9 +456,27 @@ void DD_World::Resize(int width, int height)
     if (m_deferredRenderer) m_deferredRenderer->Resize(width, height);
 }
 
+void DD_World::UpdateTransforms()
+{
+    m_transformStats = TransformStats();
+    m_transforms.SetInterpolation(m_interpolationAlpha);
+    // Local matrices in SIMD batches first, so the hierarchy pass only multiplies
+    m_transformStats.localMatricesComposed = m_transforms.UpdateLocalMatrices();
+    m_transformHierarchy.Update(m_transformStats);
+}
+
 void DD_World::Render()
 {
-    if (m_shadowEnabled && m_mainLight && m_mainLight->GetCastShadow())
+    // The camera is driven per frame, not per simulation step
+    m_camera->UpdateView();
+    UpdateTransforms();
+
+    const bool shadowPass = m_shadowEnabled && m_mainLight && m_mainLight->GetCastShadow();
+    const bool litPass = m_useDeferredRendering || (m_shadowEnabled && m_mainLight);
+    m_renderStats = RenderStats();
+    BuildRenderQueue(shadowPass, litPass);
+
+    if (shadowPass)
     {
         RenderShadowPass();
     }
@@ -288,14 +498,14 @@ void DD_World::Render()
     {
         const Matrix4 view = m_camera->GetViewMatrix();
         const Matrix4 proj = m_camera->GetProjectionMatrix();
-        for (auto& actorPtr : m_actors)
+        for (uint32_t i = 0; i < m_collisionPool.Size(); ++i)
         {
-            DD_CollisionComponent* col = actorPtr->GetCollisionComponent();
-            if (col && col->m_type == CollisionShapeType::AABB)
-            {
-                AABB aabb{actorPtr->GetPosition(), col->m_aabbHalfExtents};
-                DebugDraw::DrawAABBWire(aabb, view, proj, Vec4(1.0f, 0.0f, 0.0f, 1.0f));
-            }
+            const DD_CollisionComponent& col = m_collisionPool.At(i);
+            if (col.m_type == CollisionShapeType::None) continue;
+            const DD_Actor* actor = m_actorSlots[m_collisionPool.GetEntity(i)].actor;
+            AABB aabb = CollisionUtils::ComputeBounds(
+                CollisionUtils::MakeWorldCollider(col, actor->GetPosition(), actor->GetRotationQuat()));
+            DebugDraw::DrawAABBWire(aabb, view, proj, Vec4(1.0f, 0.0f, 0.0f, 1.0f));
         }
     }
 }
@@ -305,14 +515,7 @@ void DD_World::RenderShadowPass()
     if (!m_mainLight) return;
     DD_LightComponent* lightComp = m_mainLight->GetLightComponent();
     m_shadowRenderer->BeginShadowPass(*lightComp);
-
-    for (auto& actorPtr : m_actors)
-    {
-        if (dynamic_cast<DD_LightActor*>(actorPtr.get())) continue;
-        DD_MeshComponent* meshComp = actorPtr->GetMeshComponent();
-        if (meshComp && !meshComp->GetCastShadow()) continue;
-        m_shadowRenderer->RenderActor(actorPtr.get());
-    }
+    m_renderQueue.Submit(RenderPass::Shadow, *m_shadowRenderer, m_renderStats);
     m_shadowRenderer->EndShadowPass();
 }
 
@@ -324,11 +527,7 @@ void DD_World::RenderDeferred()
 
     // Geometry pass
     m_deferredRenderer->BeginGeometryPass(view, proj);
-    for (auto& actorPtr : m_actors)
-    {
-        if (dynamic_cast<DD_LightActor*>(actorPtr.get())) continue;
-        m_deferredRenderer->RenderActor(actorPtr.get());
-    }
+    m_renderQueue.Submit(RenderPass::Geometry, *m_deferredRenderer, m_renderStats);
     m_deferredRenderer->EndGeometryPass();
 
     // Lighting pass
@@ -342,7 +541,7 @@ void DD_World::RenderDeferred()
         {
             DD_LightComponent* lc = light->GetLightComponent();
             m_deferredRenderer->AddPointLight(
-                light->GetPosition(),
+                light->GetWorldPosition(),
                 lc->GetColor(),
                 lc->GetIntensity(),
                 lc->GetRange()
@@ -375,13 +574,75 @@ void DD_World::RenderScenePass()
     DD_LightComponent* lightComp = m_mainLight->GetLightComponent();
     m_sceneRenderer->BeginScenePass(view, proj, *lightComp, 
         m_shadowRenderer->GetShadowMap(), m_shadowRenderer->GetLightSpaceMatrix(), cameraPos);
+    m_renderQueue.Submit(RenderPass::Forward, *m_sceneRenderer, m_renderStats);
+    m_sceneRenderer->EndScenePass();
+}
+
+void DD_World::BuildRenderQueue(bool shadowPass, bool litPass)
+{
+    m_renderQueue.Clear();
+    if (!shadowPass && !litPass) return;
+
+    const Matrix4& view = m_camera->GetViewMatrix();
+    const float invFar = 1.0f / m_camera->GetFarPlane();
+    const RenderPass lit = m_useDeferredRendering ? RenderPass::Geometry : RenderPass::Forward;
+    std::vector<uint64_t>& shadowVisible = m_passVisibility[static_cast<int>(RenderPass::Shadow)];
+    std::vector<uint64_t>& litVisible = m_passVisibility[static_cast<int>(lit)];
 
-    for (auto& actorPtr : m_actors)
+    if (m_frustumCulling)
     {
-        if (dynamic_cast<DD_LightActor*>(actorPtr.get())) continue;
-        m_sceneRenderer->RenderActor(actorPtr.get());
+        // World bounds of every mesh instance, indexed like the mesh pool
+        m_culler.Clear();
+        for (uint32_t i = 0; i < m_meshPool.Size(); ++i)
+        {
+            const DD_Mesh* mesh = m_meshPool.At(i).GetMesh();
+            const Matrix4& model = m_actorSlots[m_meshPool.GetEntity(i)].actor->GetModelMatrix();
+            if (mesh) m_culler.Add(model, mesh->GetLocalCenter(), mesh->GetLocalHalfExtents());
+            else m_culler.Add(model, Vec3(0.0f), Vec3(0.0f));
+        }
+
+        // Casters outside the light's volume cannot reach the shadow map
+        if (shadowPass) m_culler.Cull(Frustum::FromMatrix(m_mainLight->GetLightComponent()->GetLightSpaceMatrix()), shadowVisible);
+        if (litPass) m_culler.Cull(Frustum::FromMatrix(m_camera->GetViewProjectionMatrix()), litVisible);
     }
-    m_sceneRenderer->EndScenePass();
+
+    for (uint32_t i = 0; i < m_meshPool.Size(); ++i)
+    {
+        const DD_MeshComponent& meshComp = m_meshPool.At(i);
+        DD_Mesh* mesh = meshComp.GetMesh();
+        if (!mesh) continue;
+        const Matrix4& model = m_actorSlots[m_meshPool.GetEntity(i)].actor->GetModelMatrix();
+
+        // Depth only: no material, so shadow casters group by mesh alone
+        if (shadowPass && meshComp.GetCastShadow())
+        {
+            if (!m_frustumCulling || DD_FrustumCuller::IsVisible(shadowVisible, i))
+            {
+                m_renderQueue.Add(RenderPass::Shadow, 0, &model, mesh, nullptr, 0.0f);
+                ++m_renderStats.visible[static_cast<int>(RenderPass::Shadow)];
+            }
+            else
+            {
+                ++m_renderStats.culled[static_cast<int>(RenderPass::Shadow)];
+            }
+        }
+        if (litPass && meshComp.IsVisible())
+        {
+            if (!m_frustumCulling || DD_FrustumCuller::IsVisible(litVisible, i))
+            {
+                // View-space depth of the actor's origin
+                const float depth = -(view[0][2] * model[3][0] + view[1][2] * model[3][1] + view[2][2] * model[3][2] + view[3][2]);
+                m_renderQueue.Add(lit, 0, &model, mesh, meshComp.GetMaterial(), depth * invFar);
+                ++m_renderStats.visible[static_cast<int>(lit)];
+            }
+            else
+            {
+                ++m_renderStats.culled[static_cast<int>(lit)];
+            }
+        }
+    }
+    m_renderQueue.Sort();
+    m_renderQueue.UploadInstances();
 }
 
 void DD_World::RenderLegacy()
@@ -391,33 +652,817 @@ void DD_World::RenderLegacy()
     for (auto& actorPtr : m_actors) actorPtr->Render(view, proj);
 }
 
-void DD_World::ProcessCollisions(float deltaTime)
+void DD_World::SetBroadphaseType(BroadphaseType type)
+{
+    if (m_broadphase && m_broadphaseType == type) return;
+
+    // Proxies are recreated lazily by the next SyncBroadphase
+    for (DD_CollisionComponent& col : m_collisionPool) col.m_proxyId = -1;
+    m_broadphase.reset();
+    m_colliderCache.Clear();
+    m_impulseCache.clear();
+    m_broadphaseType = type;
+
+    switch (type)
+    {
+    case BroadphaseType::SweepAndPrune:
+        m_broadphase = std::make_unique<DD_SweepAndPrune>();
+        break;
+    case BroadphaseType::SpatialHash:
+        m_broadphase = std::make_unique<DD_SpatialHashGrid>(m_spatialHashCellSize);
+        break;
+    case BroadphaseType::AABBTree:
+        m_broadphase = std::make_unique<DD_AABBTreeBroadphase>();
+        break;
+    case BroadphaseType::BruteForce:
+    default:
+        break;
+    }
+}
+
+void DD_World::SetSpatialHashCellSize(float cellSize)
+{
+    m_spatialHashCellSize = cellSize;
+    if (m_broadphase && m_broadphaseType == BroadphaseType::SpatialHash)
+    {
+        static_cast<DD_SpatialHashGrid*>(m_broadphase.get())->SetCellSize(cellSize);
+    }
+}
+
+// Broadphase ids are recycled, so warm start entries of the freed id go with it; a new
+// pair on the id must not inherit the impulse of a destroyed body
+void DD_World::DestroyProxy(DD_CollisionComponent* col)
+{
+    const int proxy = col->m_proxyId;
+    m_colliderCache.Remove(proxy);
+    m_broadphase->DestroyProxy(proxy);
+    col->m_proxyId = -1;
+
+    for (auto it = m_impulseCache.begin(); it != m_impulseCache.end();)
+    {
+        const int proxyA = static_cast<int>(it->first >> 32);
+        const int proxyB = static_cast<int>(it->first & 0xffffffffu);
+        if (proxyA == proxy || proxyB == proxy) it = m_impulseCache.erase(it);
+        else ++it;
+    }
+}
+
+// Registers new colliders and updates proxies of actors whose transform changed.
+// Sleeping bodies only move when something outside the solver moves them, which wakes them.
+void DD_World::SyncBroadphase()
+{
+    // Only bodies with a collider can be in a contact, so only they need waking here
+    for (auto item : View<DD_RigidBodyComponent, DD_CollisionComponent>())
+    {
+        if (m_actorSlots[item.entity].actor->IsCollisionDirty()) item.a.WakeUp();
+    }
+
+    for (uint32_t i = 0; i < m_collisionPool.Size(); ++i)
+    {
+        DD_CollisionComponent* col = &m_collisionPool.At(i);
+        DD_Actor* actor = m_actorSlots[m_collisionPool.GetEntity(i)].actor;
+
+        if (col->m_type == CollisionShapeType::None)
+        {
+            if (col->m_proxyId >= 0) DestroyProxy(col);
+            continue;
+        }
+
+        // A changed filter re-registers the proxy so stale pairs are dropped
+        const CollisionFilter filter = col->GetFilter();
+        if (col->m_proxyId >= 0 && m_broadphase->GetFilter(col->m_proxyId) != filter) DestroyProxy(col);
+
+        if (col->m_proxyId >= 0 && !actor->IsCollisionDirty()) continue;
+
+        WorldCollider collider = CollisionUtils::MakeWorldCollider(*col, actor->GetPosition(), actor->GetRotationQuat());
+        AABB bounds = CollisionUtils::ComputeBounds(collider);
+        if (col->m_proxyId < 0)
+        {
+            col->m_proxyId = m_broadphase->CreateProxy(bounds, actor, filter);
+        }
+        else
+        {
+            m_broadphase->MoveProxy(col->m_proxyId, bounds);
+        }
+        m_colliderCache.Set(col->m_proxyId, collider, actor);
+        actor->ClearCollisionDirty();
+        ++m_collisionStats.proxiesMoved;
+    }
+    m_collisionStats.proxyCount = static_cast<uint32_t>(m_broadphase->GetProxyCount());
+}
+
+void DD_World::QueryAABB(const AABB& bounds, std::vector<DD_Actor*>& outActors) const
 {
-    size_t n = m_actors.size();
-    for (size_t i = 0; i < n; ++i)
+    if (!m_broadphase)
     {
-        for (size_t j = i + 1; j < n; ++j)
+        for (uint32_t i = 0; i < m_collisionPool.Size(); ++i)
         {
-            DD_CollisionComponent* a = m_actors[i]->GetCollisionComponent();
-            DD_CollisionComponent* b = m_actors[j]->GetCollisionComponent();
-            if (!a || !b) continue;
+            const DD_CollisionComponent& col = m_collisionPool.At(i);
+            if (col.m_type == CollisionShapeType::None) continue;
+            DD_Actor* actor = m_actorSlots[m_collisionPool.GetEntity(i)].actor;
+            WorldCollider collider = CollisionUtils::MakeWorldCollider(col, actor->GetPosition(), actor->GetRotationQuat());
+            if (AABBOverlap(bounds, CollisionUtils::ComputeBounds(collider)))
+                outActors.push_back(actor);
+        }
+        return;
+    }
+
+    // Proxies of actors created since the last tick are not in the index yet
+    std::vector<int> proxies;
+    m_broadphase->Query(bounds, proxies);
+    for (int proxyId : proxies)
+    {
+        outActors.push_back(static_cast<DD_Actor*>(m_broadphase->GetUserData(proxyId)));
+    }
+}
+
+// Rays are clamped to this length so grid walks and query boxes stay bounded
+static constexpr float kMaxQueryDistance = 10000.0f;
+
+// Per-thread proxy scratch for scene queries
+static thread_local std::vector<int> s_queryProxies;
+
+// Calls fn(actor, collider, bounds) for every proxy, or for every collider in BruteForce mode
+template<typename Fn>
+void DD_World::VisitQueryCandidates(const std::vector<int>& proxies, Fn&& fn) const
+{
+    if (!m_broadphase)
+    {
+        for (uint32_t i = 0; i < m_collisionPool.Size(); ++i)
+        {
+            const DD_CollisionComponent& col = m_collisionPool.At(i);
+            if (col.m_type == CollisionShapeType::None) continue;
+            DD_Actor* actor = m_actorSlots[m_collisionPool.GetEntity(i)].actor;
+            WorldCollider collider = CollisionUtils::MakeWorldCollider(col, actor->GetPosition(), actor->GetRotationQuat());
+            fn(actor, collider, CollisionUtils::ComputeBounds(collider));
+        }
+        return;
+    }
+
+    for (int proxyId : proxies)
+    {
+        if (!m_colliderCache.IsValid(proxyId)) continue;
+        fn(m_colliderCache.GetActor(proxyId), m_colliderCache.GetCollider(proxyId), m_colliderCache.GetBounds(proxyId));
+    }
+}
 
-            if (a->m_type == CollisionShapeType::AABB && b->m_type == CollisionShapeType::AABB)
+bool DD_World::Raycast(const Ray& ray, RaycastHit& outHit, const DD_Actor* ignore) const
+{
+    outHit = RaycastHit();
+    float length = glm::length(ray.direction);
+    if (length < DD_SMALL_NUMBER) return false;
+    const Vec3 dir = ray.direction / length;
+    float best = std::min(ray.maxDistance, kMaxQueryDistance);
+
+    std::vector<int>& proxies = s_queryProxies;
+    proxies.clear();
+    if (m_broadphase) m_broadphase->QueryRay(ray.origin, dir, best, proxies);
+
+    VisitQueryCandidates(proxies, [&](DD_Actor* actor, const WorldCollider& collider, const AABB&)
+    {
+        if (actor == ignore) return;
+        float t;
+        Vec3 normal;
+        if (!CollisionUtils::RayVsCollider(ray.origin, dir, best, collider, t, normal)) return;
+        best = t;
+        outHit.actor = actor;
+        outHit.distance = t;
+        outHit.normal = normal;
+    });
+
+    if (!outHit.actor) return false;
+    outHit.point = ray.origin + dir * outHit.distance;
+    return true;
+}
+
+int DD_World::RaycastBatch(const Ray* rays, int count, RaycastHit* outHits, const DD_Actor* ignore) const
+{
+    int hitCount = 0;
+    std::vector<int>& proxies = s_queryProxies;
+
+    for (int first = 0; first < count; first += RayPacket::Width)
+    {
+        const int lanes = std::min(static_cast<int>(RayPacket::Width), count - first);
+        RayPacket packet;
+        Vec3 dirs[RayPacket::Width];
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            const Ray& ray = rays[first + lane];
+            outHits[first + lane] = RaycastHit();
+            float length = glm::length(ray.direction);
+            dirs[lane] = length > DD_SMALL_NUMBER ? ray.direction / length : Vec3(0.0f);
+            // Zero-length rays keep a negative maxT and never hit
+            packet.Add(ray.origin, dirs[lane], length > DD_SMALL_NUMBER ? std::min(ray.maxDistance, kMaxQueryDistance) : -1.0f);
+        }
+
+        proxies.clear();
+        if (m_broadphase) m_broadphase->QueryRayPacket(packet, proxies);
+
+        VisitQueryCandidates(proxies, [&](DD_Actor* actor, const WorldCollider& collider, const AABB& bounds)
+        {
+            if (actor == ignore) return;
+            int laneMask = CollisionUtils::TestRayPacketVsBox(packet, bounds.center - bounds.halfExtents, bounds.center + bounds.halfExtents);
+            for (int lane = 0; laneMask != 0; ++lane, laneMask >>= 1)
             {
-                AABB A{m_actors[i]->GetPosition(), a->m_aabbHalfExtents};
-                AABB B{m_actors[j]->GetPosition(), b->m_aabbHalfExtents};
-                Vec3 mtv;
-                if (CollisionUtils::TestAABBvsAABB(A, B, mtv))
-                {
-                    float ma = a->m_mass, mb = b->m_mass;
-                    float total = ma + mb;
-                    if (total < DD_SMALL_NUMBER) continue;
-                    m_actors[i]->AddPosition(-mtv * (mb / total));
-                    m_actors[j]->AddPosition(mtv * (ma / total));
-                }
+                if (!(laneMask & 1)) continue;
+                const Ray& ray = rays[first + lane];
+                float t;
+                Vec3 normal;
+                if (!CollisionUtils::RayVsCollider(ray.origin, dirs[lane], packet.maxT[lane], collider, t, normal)) continue;
+
+                // Shrinking maxT lets later slab tests reject more candidates
+                packet.maxT[lane] = t;
+                RaycastHit& hit = outHits[first + lane];
+                hit.actor = actor;
+                hit.distance = t;
+                hit.normal = normal;
             }
+        });
+
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            RaycastHit& hit = outHits[first + lane];
+            if (!hit.actor) continue;
+            hit.point = rays[first + lane].origin + dirs[lane] * hit.distance;
+            ++hitCount;
         }
     }
+    return hitCount;
+}
+
+bool DD_World::SweepAABB(const AABB& box, const Vec3& delta, RaycastHit& outHit, const DD_Actor* ignore) const
+{
+    outHit = RaycastHit();
+    const AABB swept{box.center + delta * 0.5f, box.halfExtents + glm::abs(delta) * 0.5f};
+
+    std::vector<int>& proxies = s_queryProxies;
+    proxies.clear();
+    if (m_broadphase) m_broadphase->Query(swept, proxies);
+
+    // Sweeping the box is a ray cast of its center against targets grown by its extents
+    float bestT = 1.0f;
+    VisitQueryCandidates(proxies, [&](DD_Actor* actor, const WorldCollider&, const AABB& bounds)
+    {
+        if (actor == ignore) return;
+        AABB expanded{bounds.center, bounds.halfExtents + box.halfExtents};
+        float t;
+        Vec3 normal;
+        if (!CollisionUtils::RayVsAABB(box.center, delta, bestT, expanded, t, normal)) return;
+        bestT = t;
+        outHit.actor = actor;
+        outHit.normal = normal;
+    });
+
+    if (!outHit.actor) return false;
+    outHit.distance = bestT * glm::length(delta);
+    outHit.point = box.center + delta * bestT;
+    return true;
+}
+
+void DD_World::OverlapSphere(const Sphere& sphere, std::vector<DD_Actor*>& outActors, const DD_Actor* ignore) const
+{
+    WorldCollider query;
+    query.type = CollisionShapeType::Sphere;
+    query.sphere = sphere;
+
+    std::vector<int>& proxies = s_queryProxies;
+    proxies.clear();
+    if (m_broadphase) m_broadphase->Query(CollisionUtils::ComputeBounds(sphere), proxies);
+
+    VisitQueryCandidates(proxies, [&](DD_Actor* actor, const WorldCollider& collider, const AABB&)
+    {
+        if (actor == ignore) return;
+        Vec3 mtv;
+        if (CollisionUtils::TestColliders(query, collider, mtv)) outActors.push_back(actor);
+    });
+}
+
+bool DD_World::ResolveCollision(DD_Actor* actorA, DD_Actor* actorB)
+{
+    DD_CollisionComponent* a = actorA->GetCollisionComponent();
+    DD_CollisionComponent* b = actorB->GetCollisionComponent();
+    if (!a || !b) return false;
+
+    if (a->m_type == CollisionShapeType::None || b->m_type == CollisionShapeType::None) return false;
+
+    ++m_collisionStats.narrowphaseTests;
+    WorldCollider A = CollisionUtils::MakeWorldCollider(*a, actorA->GetPosition(), actorA->GetRotationQuat());
+    WorldCollider B = CollisionUtils::MakeWorldCollider(*b, actorB->GetPosition(), actorB->GetRotationQuat());
+    Vec3 mtv;
+    if (!CollisionUtils::TestColliders(A, B, mtv)) return false;
+
+    ++m_collisionStats.contacts;
+    ApplyContact(actorA, actorB, mtv);
+    return true;
+}
+
+// Splits the MTV between both actors by mass; static and kinematic actors do not move
+void DD_World::ApplyContact(DD_Actor* actorA, DD_Actor* actorB, const Vec3& mtv)
+{
+    float invA = actorA->GetCollisionComponent()->GetInverseMass();
+    float invB = actorB->GetCollisionComponent()->GetInverseMass();
+    float total = invA + invB;
+    if (total < DD_SMALL_NUMBER) return;
+    if (invA > 0.0f) actorA->AddPosition(-mtv * (invA / total));
+    if (invB > 0.0f) actorB->AddPosition(mtv * (invB / total));
+}
+
+// Below this many contacts waking the workers costs more than it saves
+static constexpr size_t kParallelContactThreshold = 64;
+// Islands are mostly a handful of contacts; fewer per job is all scheduling overhead
+static constexpr int kIslandsPerJob = 8;
+
+// Applies contacts island by island. Islands share no actors and each one keeps list
+// order, so the result is bit-identical to a serial pass for any worker count.
+void DD_World::ResolveContacts()
+{
+    // ApplyContact only reads zero inverse mass actors, so they may touch several islands
+    m_fixedProxies.clear();
+    auto markProxy = [this](int proxy)
+    {
+        if (proxy >= static_cast<int>(m_fixedProxies.size())) m_fixedProxies.resize(proxy + 1, 0);
+        m_fixedProxies[proxy] = m_colliderCache.GetActor(proxy)->GetCollisionComponent()->GetInverseMass() > 0.0f ? 0 : 1;
+    };
+    for (const CollisionContact& contact : m_contacts)
+    {
+        markProxy(contact.proxyA);
+        markProxy(contact.proxyB);
+    }
+    m_islands.Build(m_contacts, &m_fixedProxies);
+    const int islandCount = m_islands.GetIslandCount();
+
+    auto resolveIsland = [this](int island)
+    {
+        const int* contacts = m_islands.GetIslandContacts(island);
+        const int count = m_islands.GetIslandSize(island);
+        for (int i = 0; i < count; ++i)
+        {
+            const CollisionContact& contact = m_contacts[contacts[i]];
+            ApplyContact(m_colliderCache.GetActor(contact.proxyA), m_colliderCache.GetActor(contact.proxyB), contact.mtv);
+        }
+    };
+
+    if (islandCount > 1 && m_contacts.size() >= kParallelContactThreshold)
+    {
+        gJobSystem.ParallelFor(islandCount, kIslandsPerJob, [&](int begin, int end)
+        {
+            for (int island = begin; island < end; ++island) resolveIsland(island);
+        });
+    }
+    else
+    {
+        for (int island = 0; island < islandCount; ++island) resolveIsland(island);
+    }
+
+    m_collisionStats.islands = static_cast<uint32_t>(islandCount);
+    for (int island = 0; island < islandCount; ++island)
+    {
+        uint32_t size = static_cast<uint32_t>(m_islands.GetIslandSize(island));
+        if (size > m_collisionStats.largestIsland) m_collisionStats.largestIsland = size;
+    }
+}
+
+// Enabled rigid body of an actor, or nullptr when the actor is static
+static DD_RigidBodyComponent* GetActiveBody(const DD_Actor* actor)
+{
+    DD_RigidBodyComponent* body = actor->GetRigidBodyComponent();
+    return body && body->IsEnabled() ? body : nullptr;
+}
+
+static bool IsAwake(const DD_RigidBodyComponent* body)
+{
+    return body && !body->IsSleeping();
+}
+
+// Runs the narrowphase on the broadphase pairs against the collider cache snapshot.
+// Box-box candidates of the same proxy are tested together with the SIMD batch kernel.
+// Pairs of sleeping bodies and static colliders are skipped before any shape test.
+void DD_World::DetectContacts()
+{
+    m_contacts.clear();
+    m_bodyContacts.clear();
+
+    AABBBatch batch;
+    int batchProxies[AABBBatch::Width];
+    Vec3 batchMTV[AABBBatch::Width];
+
+    const size_t pairCount = m_broadphasePairs.size();
+    size_t i = 0;
+    while (i < pairCount)
+    {
+        const int proxyA = m_broadphasePairs[i].proxyA;
+        const bool boxA = m_colliderCache.GetType(proxyA) == CollisionShapeType::AABB;
+        const AABB boundsA = m_colliderCache.GetBounds(proxyA);
+        const DD_RigidBodyComponent* bodyA = GetActiveBody(m_colliderCache.GetActor(proxyA));
+
+        auto flushBatch = [&]()
+        {
+            if (batch.count == 0) return;
+            uint32_t hits = CollisionUtils::TestAABBvsAABBBatch(boundsA, batch, batchMTV);
+            for (int lane = 0; lane < batch.count; ++lane)
+            {
+                if (hits & (1u << lane)) AddContact(proxyA, batchProxies[lane], batchMTV[lane]);
+            }
+            m_collisionStats.batchedTests += static_cast<uint32_t>(batch.count);
+            batch.count = 0;
+        };
+
+        // Pairs are sorted, so every candidate of proxyA is adjacent
+        for (; i < pairCount && m_broadphasePairs[i].proxyA == proxyA; ++i)
+        {
+            const int proxyB = m_broadphasePairs[i].proxyB;
+            const DD_RigidBodyComponent* bodyB = GetActiveBody(m_colliderCache.GetActor(proxyB));
+            if ((bodyA || bodyB) && !IsAwake(bodyA) && !IsAwake(bodyB)) continue;
+            ++m_collisionStats.narrowphaseTests;
+
+            if (boxA && m_colliderCache.GetType(proxyB) == CollisionShapeType::AABB)
+            {
+                batchProxies[batch.count] = proxyB;
+                m_colliderCache.Gather(proxyB, batch);
+                if (batch.count == AABBBatch::Width) flushBatch();
+                continue;
+            }
+
+            Vec3 mtv;
+            if (CollisionUtils::TestColliders(m_colliderCache.GetCollider(proxyA), m_colliderCache.GetCollider(proxyB), mtv))
+            {
+                AddContact(proxyA, proxyB, mtv);
+            }
+        }
+        flushBatch();
+    }
+}
+
+// Contacts without a rigid body keep the positional MTV split; the rest go to the solver
+void DD_World::AddContact(int proxyA, int proxyB, const Vec3& mtv)
+{
+    DD_Actor* actorA = m_colliderCache.GetActor(proxyA);
+    DD_Actor* actorB = m_colliderCache.GetActor(proxyB);
+    DD_RigidBodyComponent* bodyA = GetActiveBody(actorA);
+    DD_RigidBodyComponent* bodyB = GetActiveBody(actorB);
+    if (!bodyA && !bodyB)
+    {
+        m_contacts.push_back({ proxyA, proxyB, mtv });
+        return;
+    }
+
+    auto inverseMass = [](const DD_Actor* actor, const DD_RigidBodyComponent* body)
+    {
+        return body ? actor->GetCollisionComponent()->GetInverseMass() : 0.0f;
+    };
+
+    BodyContact contact;
+    contact.depth = glm::length(mtv);
+    contact.invMassA = inverseMass(actorA, bodyA);
+    contact.invMassB = inverseMass(actorB, bodyB);
+    if (contact.depth < DD_SMALL_NUMBER || contact.invMassA + contact.invMassB < DD_SMALL_NUMBER) return;
+
+    // A body touched by an awake one wakes up with it
+    if (bodyA) bodyA->WakeUp();
+    if (bodyB) bodyB->WakeUp();
+
+    contact.proxyA = proxyA;
+    contact.proxyB = proxyB;
+    contact.bodyA = bodyA;
+    contact.bodyB = bodyB;
+    contact.normal = mtv / contact.depth;
+    contact.bounce = 0.0f;
+    contact.impulse = 0.0f;
+    m_bodyContacts.push_back(contact);
+}
+
+// Solver tuning
+static constexpr int kVelocityIterations = 8;
+static constexpr float kRestitutionThreshold = 1.0f;  // Slower impacts do not bounce
+static constexpr float kWarmStartMinCos = 0.95f;      // Cached impulses are dropped when the normal turns
+static constexpr float kPenetrationSlop = 0.01f;
+static constexpr float kPositionCorrection = 0.2f;    // Fraction of the penetration removed per tick
+static constexpr float kSleepVelocity = 0.05f;
+static constexpr float kTimeToSleep = 0.5f;
+static constexpr float kSweepSkin = 0.005f;           // Swept bodies stop this far before the impact
+
+static uint64_t ContactPairKey(int a, int b)
+{
+    return (static_cast<uint64_t>(a) << 32) | static_cast<uint32_t>(b);
+}
+
+void DD_World::IntegrateVelocities(float deltaTime)
+{
+    for (DD_RigidBodyComponent& bodyRef : m_bodyPool)
+    {
+        DD_RigidBodyComponent* body = &bodyRef;
+        if (!body->GetOwner() || !body->IsEnabled()) continue;
+        if (body->IsSleeping())
+        {
+            ++m_collisionStats.sleepingBodies;
+            continue;
+        }
+        ++m_collisionStats.awakeBodies;
+
+        // Kinematic and static colliders keep their velocity
+        Vec3 velocity = body->GetVelocity();
+        const DD_CollisionComponent* col = body->GetOwner()->GetCollisionComponent();
+        if (!col || col->m_bodyType == CollisionBodyType::Dynamic)
+        {
+            velocity += m_gravity * (body->GetGravityScale() * deltaTime);
+        }
+        velocity *= 1.0f / (1.0f + deltaTime * body->GetLinearDamping());
+        body->SetVelocity(velocity);
+    }
+}
+
+// Sequential impulses on the contact normals, warm started from last tick's impulses
+void DD_World::SolveBodyContacts()
+{
+    auto relativeVelocity = [](const BodyContact& c)
+    {
+        Vec3 vA = c.bodyA ? c.bodyA->GetVelocity() : Vec3(0.0f);
+        Vec3 vB = c.bodyB ? c.bodyB->GetVelocity() : Vec3(0.0f);
+        return glm::dot(vB - vA, c.normal);
+    };
+    auto applyImpulse = [](const BodyContact& c, float impulse)
+    {
+        if (c.bodyA && c.invMassA > 0.0f) c.bodyA->SetVelocity(c.bodyA->GetVelocity() - c.normal * (impulse * c.invMassA));
+        if (c.bodyB && c.invMassB > 0.0f) c.bodyB->SetVelocity(c.bodyB->GetVelocity() + c.normal * (impulse * c.invMassB));
+    };
+
+    for (BodyContact& c : m_bodyContacts)
+    {
+        // Restitution uses the approach speed before any impulse of this tick
+        float vn = relativeVelocity(c);
+        if (vn < -kRestitutionThreshold)
+        {
+            float restitutionA = c.bodyA ? c.bodyA->GetRestitution() : 0.0f;
+            float restitutionB = c.bodyB ? c.bodyB->GetRestitution() : 0.0f;
+            c.bounce = -std::max(restitutionA, restitutionB) * vn;
+        }
+
+        auto cached = m_impulseCache.find(ContactPairKey(c.proxyA, c.proxyB));
+        if (cached != m_impulseCache.end() && glm::dot(cached->second.normal, c.normal) > kWarmStartMinCos)
+        {
+            c.impulse = cached->second.impulse;
+            applyImpulse(c, c.impulse);
+            ++m_collisionStats.warmStarted;
+        }
+    }
+
+    for (int iteration = 0; iteration < kVelocityIterations; ++iteration)
+    {
+        for (BodyContact& c : m_bodyContacts)
+        {
+            float delta = (c.bounce - relativeVelocity(c)) / (c.invMassA + c.invMassB);
+
+            // Clamp the accumulated impulse, not the increment, so contacts can relax
+            float impulse = std::max(c.impulse + delta, 0.0f);
+            applyImpulse(c, impulse - c.impulse);
+            c.impulse = impulse;
+        }
+    }
+
+    // Keep entries of sleeping pairs so they warm start again when woken
+    auto isSleeping = [this](int proxy)
+    {
+        if (!m_colliderCache.IsValid(proxy)) return false;
+        const DD_RigidBodyComponent* body = GetActiveBody(m_colliderCache.GetActor(proxy));
+        return body && body->IsSleeping();
+    };
+    for (auto it = m_impulseCache.begin(); it != m_impulseCache.end();)
+    {
+        CachedImpulse& entry = it->second;
+        if (entry.touched)
+        {
+            entry.touched = false;
+            ++it;
+            continue;
+        }
+        int proxyA = static_cast<int>(it->first >> 32);
+        int proxyB = static_cast<int>(it->first & 0xffffffffu);
+        bool valid = m_colliderCache.IsValid(proxyA) && m_colliderCache.IsValid(proxyB);
+        if (valid && (isSleeping(proxyA) || isSleeping(proxyB))) ++it;
+        else it = m_impulseCache.erase(it);
+    }
+    for (const BodyContact& c : m_bodyContacts)
+    {
+        m_impulseCache[ContactPairKey(c.proxyA, c.proxyB)] = { c.normal, c.impulse, true };
+    }
+}
+
+// Bodies sleep island by island: a stack only sleeps once every body in it is slow.
+// Static colliders are folded onto the body touching them so the ground does not join
+// every stack standing on it into one island.
+void DD_World::UpdateSleeping(float deltaTime)
+{
+    for (DD_RigidBodyComponent& bodyRef : m_bodyPool)
+    {
+        DD_RigidBodyComponent* body = &bodyRef;
+        if (!body->GetOwner() || !body->IsEnabled() || body->IsSleeping()) continue;
+
+        const Vec3& v = body->GetVelocity();
+        bool slow = body->CanSleep() && glm::dot(v, v) < kSleepVelocity * kSleepVelocity;
+        body->SetSleepTimer(slow ? body->GetSleepTimer() + deltaTime : 0.0f);
+    }
+
+    m_sleepLinks.clear();
+    for (const BodyContact& c : m_bodyContacts)
+    {
+        int proxyA = c.bodyA ? c.proxyA : c.proxyB;
+        int proxyB = c.bodyB ? c.proxyB : c.proxyA;
+        m_sleepLinks.push_back({ proxyA, proxyB, c.normal });
+    }
+    m_islands.Build(m_sleepLinks);
+
+    // Every body of an island takes the island's smallest timer
+    for (int island = 0; island < m_islands.GetIslandCount(); ++island)
+    {
+        const int* links = m_islands.GetIslandContacts(island);
+        const int count = m_islands.GetIslandSize(island);
+
+        float islandTimer = kTimeToSleep;
+        for (int i = 0; i < count; ++i)
+        {
+            const BodyContact& c = m_bodyContacts[links[i]];
+            if (c.bodyA) islandTimer = std::min(islandTimer, c.bodyA->GetSleepTimer());
+            if (c.bodyB) islandTimer = std::min(islandTimer, c.bodyB->GetSleepTimer());
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            const BodyContact& c = m_bodyContacts[links[i]];
+            if (c.bodyA) c.bodyA->SetSleepTimer(islandTimer);
+            if (c.bodyB) c.bodyB->SetSleepTimer(islandTimer);
+        }
+    }
+
+    for (DD_RigidBodyComponent& bodyRef : m_bodyPool)
+    {
+        DD_RigidBodyComponent* body = &bodyRef;
+        if (!body->GetOwner() || !body->IsEnabled() || body->IsSleeping()) continue;
+        if (body->GetSleepTimer() >= kTimeToSleep) body->PutToSleep();
+    }
+}
+
+// Continuous collision for bodies that move further than their own extent in one tick,
+// which could otherwise skip over thin colliders. Targets are treated as resting boxes at
+// their current bounds; colliders the body already overlaps are left to the solver.
+bool DD_World::SweepFastBody(const DD_RigidBodyComponent* body, const Vec3& delta, float& outTOI, Vec3& outNormal)
+{
+    const DD_Actor* actor = body->GetOwner();
+    const DD_CollisionComponent* col = actor->GetCollisionComponent();
+    if (!col || col->m_proxyId < 0 || !m_colliderCache.IsValid(col->m_proxyId)) return false;
+
+    const int self = col->m_proxyId;
+    const AABB box{actor->GetPosition(), m_colliderCache.GetBounds(self).halfExtents};
+    if (fabsf(delta.x) <= box.halfExtents.x && fabsf(delta.y) <= box.halfExtents.y && fabsf(delta.z) <= box.halfExtents.z)
+        return false;
+    ++m_collisionStats.ccdSweeps;
+
+    const AABB swept{box.center + delta * 0.5f, box.halfExtents + glm::abs(delta) * 0.5f};
+    std::vector<int>& proxies = s_queryProxies;
+    proxies.clear();
+    m_broadphase->Query(swept, proxies);
+
+    const CollisionFilter& filter = m_broadphase->GetFilter(self);
+    bool hit = false;
+    outTOI = 1.0f;
+    for (int proxyId : proxies)
+    {
+        if (proxyId == self || !m_colliderCache.IsValid(proxyId)) continue;
+        if (!ShouldCollide(filter, m_broadphase->GetFilter(proxyId))) continue;
+
+        float toi;
+        Vec3 normal;
+        if (!CollisionUtils::SweepAABBvsAABB(box, delta, m_colliderCache.GetBounds(proxyId), toi, normal)) continue;
+        if (toi >= outTOI) continue;
+        outTOI = toi;
+        outNormal = normal;
+        hit = true;
+    }
+    return hit;
+}
+
+// Pushes bodies out of penetration and moves them by their velocity, stopping fast
+// bodies at their first time of impact instead of substepping the whole world.
+// Bodies that fell asleep this tick stay put so their proxies are not marked dirty.
+void DD_World::IntegratePositions(float deltaTime)
+{
+    for (const BodyContact& c : m_bodyContacts)
+    {
+        float correction = std::max(c.depth - kPenetrationSlop, 0.0f) * kPositionCorrection / (c.invMassA + c.invMassB);
+        if (correction <= 0.0f) continue;
+        if (IsAwake(c.bodyA)) c.bodyA->GetOwner()->AddPosition(-c.normal * (correction * c.invMassA));
+        if (IsAwake(c.bodyB)) c.bodyB->GetOwner()->AddPosition(c.normal * (correction * c.invMassB));
+    }
+
+    for (DD_RigidBodyComponent& bodyRef : m_bodyPool)
+    {
+        DD_RigidBodyComponent* body = &bodyRef;
+        if (!body->GetOwner() || !body->IsEnabled() || body->IsSleeping()) continue;
+
+        Vec3 v = body->GetVelocity();
+        if (glm::dot(v, v) <= 0.0f) continue;
+
+        Vec3 delta = v * deltaTime;
+        float toi;
+        Vec3 normal;
+        if (SweepFastBody(body, delta, toi, normal))
+        {
+            ++m_collisionStats.ccdHits;
+
+            // Stop just short of the surface and bounce like a regular contact would
+            float length = glm::length(delta);
+            delta *= std::max(toi - kSweepSkin / length, 0.0f);
+            float vn = glm::dot(v, normal);
+            if (vn < 0.0f)
+            {
+                float restitution = vn < -kRestitutionThreshold ? body->GetRestitution() : 0.0f;
+                body->SetVelocity(v - normal * (vn * (1.0f + restitution)));
+            }
+        }
+        body->GetOwner()->AddPosition(delta);
+    }
+}
+
+void DD_World::ProcessCollisions(float deltaTime)
+{
+    using clock = std::chrono::steady_clock;
+    m_collisionStats = CollisionStats();
+
+    if (!m_broadphase)
+    {
+        ProcessCollisionsBruteForce();
+        return;
+    }
+
+    auto broadStart = clock::now();
+    IntegrateVelocities(deltaTime);
+    SyncBroadphase();
+
+    // Nothing moved and every body sleeps: last tick's contacts are all resolved
+    if (m_collisionStats.proxiesMoved == 0 && m_collisionStats.awakeBodies == 0)
+    {
+        m_collisionStats.broadphaseMs = std::chrono::duration<float, std::milli>(clock::now() - broadStart).count();
+        return;
+    }
+
+    m_broadphase->ComputePairs(m_broadphasePairs);
+    m_collisionStats.candidatePairs = static_cast<uint32_t>(m_broadphasePairs.size());
+    m_collisionStats.filteredPairs = m_broadphase->GetFilteredPairCount();
+    m_broadphase->ResetFilteredPairCount();
+    for (const BroadphasePair& pair : m_broadphasePairs)
+    {
+        CountLayerPair(m_broadphase->GetFilter(pair.proxyA), m_broadphase->GetFilter(pair.proxyB));
+    }
+    auto narrowStart = clock::now();
+
+    // Detect every contact first, then resolve, so the tests read a consistent snapshot
+    DetectContacts();
+    ResolveContacts();
+    SolveBodyContacts();
+    UpdateSleeping(deltaTime);
+    IntegratePositions(deltaTime);
+    m_collisionStats.contacts = static_cast<uint32_t>(m_contacts.size() + m_bodyContacts.size());
+    auto narrowEnd = clock::now();
+
+    m_collisionStats.broadphaseMs = std::chrono::duration<float, std::milli>(narrowStart - broadStart).count();
+    m_collisionStats.narrowphaseMs = std::chrono::duration<float, std::milli>(narrowEnd - narrowStart).count();
+}
+
+void DD_World::CountLayerPair(const CollisionFilter& a, const CollisionFilter& b)
+{
+    const uint32_t layers = a.layers | b.layers;
+    for (int bit = 0; bit < 32; ++bit)
+    {
+        if (layers & (1u << bit)) ++m_collisionStats.layerPairs[bit];
+    }
+}
+
+// Legacy all-pairs loop, selectable with BroadphaseType::BruteForce for comparison
+void DD_World::ProcessCollisionsBruteForce()
+{
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+
+    const uint32_t n = m_collisionPool.Size();
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        DD_Actor* actorA = m_actorSlots[m_collisionPool.GetEntity(i)].actor;
+        ++m_collisionStats.proxyCount;
+        const CollisionFilter filterA = m_collisionPool.At(i).GetFilter();
+        for (uint32_t j = i + 1; j < n; ++j)
+        {
+            DD_Actor* actorB = m_actorSlots[m_collisionPool.GetEntity(j)].actor;
+            const CollisionFilter filterB = m_collisionPool.At(j).GetFilter();
+            if (!ShouldCollide(filterA, filterB))
+            {
+                ++m_collisionStats.filteredPairs;
+                continue;
+            }
+            ++m_collisionStats.candidatePairs;
+            CountLayerPair(filterA, filterB);
+            ResolveCollision(actorA, actorB);
+        }
+    }
+
+    m_collisionStats.narrowphaseMs = std::chrono::duration<float, std::milli>(clock::now() - start).count();
 }
 
 void DD_World::SetDebugDraw(bool enabled) { DebugDraw::Enabled = enabled; }
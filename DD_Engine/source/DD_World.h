@@ -1,6 +1,20 @@
 #pragma once
 
 #include "DD_GLHelper.h"
+#include "DD_Broadphase.h"
+#include "DD_ColliderCache.h"
+#include "DD_CollisionIslands.h"
+#include "DD_TransformHierarchy.h"
+#include "DD_TransformStorage.h"
+#include "DD_ComponentPool.h"
+#include "DD_FrustumCuller.h"
+#include "DD_MoverSystem.h"
+#include "DD_RenderQueue.h"
+#include "DD_MeshComponent.h"
+#include "DD_RigidBodyComponent.h"
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 class DD_Light;
 class DD_LightActor;
@@ -9,6 +23,35 @@ class DD_SceneRenderer;
 class DD_DeferredRenderer;
 class DD_Material;
 class DD_Texture;
+class DD_CommandBuffer;
+
+// Per-frame counters of the batched world matrix update
+struct TransformStats
+{
+    uint32_t localMatricesComposed = 0;
+    uint32_t matricesRebuilt = 0;
+    uint32_t matricesReused = 0;
+};
+
+// Generational reference to an actor in a world. Removing the actor bumps its slot's
+// generation, so an old handle stays detectably stale after the slot is reused.
+struct ActorHandle
+{
+    uint32_t index = 0xFFFFFFFFu;
+    uint32_t generation = 0;
+
+    bool operator==(const ActorHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const ActorHandle& other) const { return !(*this == other); }
+};
+
+// Result of a scene ray or sweep query
+struct RaycastHit
+{
+    class DD_Actor* actor = nullptr;  // nullptr on a miss
+    float distance = 0.0f;            // Along the ray, or along delta for sweeps
+    Vec3 point = Vec3(0.0f);          // Hit point, or the box center at impact for sweeps
+    Vec3 normal = Vec3(0.0f);
+};
 
 class DD_World
 {
@@ -22,15 +65,47 @@ public:
     void Render();
     void Resize(int width, int height);
 
+    // Actor updates run on the job system's threads unless disabled (for debugging)
+    void SetParallelUpdate(bool enabled) { m_parallelUpdate = enabled; }
+    bool IsParallelUpdate() const { return m_parallelUpdate; }
+
+    // Fraction of a fixed step elapsed since the last Update. Rendering blends actors that
+    // moved during that step between their previous and current transforms; 1 disables it.
+    void SetInterpolationAlpha(float alpha) { m_interpolationAlpha = alpha; }
+    float GetInterpolationAlpha() const { return m_interpolationAlpha; }
+
     void SetDebugDraw(bool enabled);
     void SetDeferredRendering(bool enabled) { m_useDeferredRendering = enabled; }
     bool IsDeferredRendering() const { return m_useDeferredRendering; }
+    // Draws runs of actors sharing a mesh and material with one instanced call
+    void SetInstancedRendering(bool enabled) { m_renderQueue.SetInstancingEnabled(enabled); }
+    bool IsInstancedRendering() const { return m_renderQueue.IsInstancingEnabled(); }
+    // Skips mesh instances outside the camera frustum, and shadow casters outside the
+    // light's volume
+    void SetFrustumCulling(bool enabled) { m_frustumCulling = enabled; }
+    bool IsFrustumCulling() const { return m_frustumCulling; }
 
-    // Actor management
-    void AddActor(class DD_Actor* actor);
+    // Actor management. Adding and removing are O(1); removal moves the last actor into
+    // the freed place, so GetActors() order is not stable.
+    ActorHandle AddActor(std::unique_ptr<class DD_Actor> actor);
     void RemoveActor(class DD_Actor* actor);
+    void RemoveActor(ActorHandle handle);
     const std::vector<std::unique_ptr<class DD_Actor>>& GetActors() const { return m_actors; }
 
+    // nullptr for stale handles
+    class DD_Actor* GetActor(ActorHandle handle) const;
+    ActorHandle GetHandle(const class DD_Actor* actor) const;
+    bool IsValid(ActorHandle handle) const { return GetActor(handle) != nullptr; }
+
+    // Deferred spawn, destroy and component attach. Returns the calling thread's buffer,
+    // which may be recorded into while Update iterates actors. Update applies every
+    // buffer in one batch after PostTick.
+    DD_CommandBuffer& GetCommandBuffer();
+    // Applies and resets all command buffers now. Must not run while actors are iterated.
+    void FlushCommands();
+    // Commands applied by the last flush
+    uint32_t GetAppliedCommandCount() const { return m_appliedCommandCount; }
+
     // Light management
     DD_LightActor* CreateDirectionalLight();
     DD_LightActor* CreatePointLight(const Vec3& position, const Vec3& color, float intensity, float radius);
@@ -39,19 +114,93 @@ public:
 
     class DD_Camera* GetCamera() const { return m_camera.get(); }
 
+    // Procedural motion for actors in this world
+    DD_MoverSystem& GetMovers() { return m_movers; }
+
+    const TransformStats& GetTransformStats() const { return m_transformStats; }
+    // Draws and state changes of the last Render
+    const RenderStats& GetRenderStats() const { return m_renderStats; }
+
     // Shadow settings
     void SetShadowEnabled(bool enabled) { m_shadowEnabled = enabled; }
     bool IsShadowEnabled() const { return m_shadowEnabled; }
 
+    // Collision settings
+    void SetBroadphaseType(BroadphaseType type);
+    BroadphaseType GetBroadphaseType() const { return m_broadphaseType; }
+    void SetSpatialHashCellSize(float cellSize);
+    float GetSpatialHashCellSize() const { return m_spatialHashCellSize; }
+    const CollisionStats& GetCollisionStats() const { return m_collisionStats; }
+
+    // Spatial index shared by collision and scene queries (null in BruteForce mode).
+    // Only actors with a collision component are indexed; render culling does not use it
+    // (see SetFrustumCulling).
+    const DD_Broadphase* GetBroadphase() const { return m_broadphase.get(); }
+    void QueryAABB(const AABB& bounds, std::vector<class DD_Actor*>& outActors) const;
+
+    // Scene queries against the collider snapshot taken by the last collision update.
+    // ignore is skipped (usually the querying actor). Safe to call from several threads.
+    bool Raycast(const Ray& ray, RaycastHit& outHit, const class DD_Actor* ignore = nullptr) const;
+    // Closest hit for every ray, tested in packets of four with SIMD slab tests.
+    // Returns the number of rays that hit something.
+    int RaycastBatch(const Ray* rays, int count, RaycastHit* outHits, const class DD_Actor* ignore = nullptr) const;
+    // First collider touched by box moving along delta. OBB and sphere colliders are swept
+    // against their bounding box.
+    bool SweepAABB(const AABB& box, const Vec3& delta, RaycastHit& outHit, const class DD_Actor* ignore = nullptr) const;
+    void OverlapSphere(const Sphere& sphere, std::vector<class DD_Actor*>& outActors, const class DD_Actor* ignore = nullptr) const;
+
+    // Rigid bodies. Mass comes from the actor's collision component; colliders without a
+    // body are static for them. Bodies are only simulated when a broadphase is active.
+    // Physics and scene queries use the actor's local transform, so this and
+    // AddCollisionComponent return nullptr for an actor with a parent.
+    DD_RigidBodyComponent* CreateRigidBody(class DD_Actor* actor);
+
+    // Components stored in the world's pools and attached to the actor, which must have
+    // been added to this world. Pointers stay valid until a component of the same type is
+    // added or removed; re-read them through the actor afterwards.
+    DD_MeshComponent* AddMeshComponent(class DD_Actor* actor);
+    DD_CollisionComponent* AddCollisionComponent(class DD_Actor* actor);
+
+    // Entities with both components, in A's packed order
+    template<typename A, typename B>
+    DD_View<A, B> View() { return DD_View<A, B>(GetPool<A>(), GetPool<B>()); }
+
+    // Actor of an entity id (the handle index), nullptr once removed
+    class DD_Actor* GetActorByEntity(uint32_t entity) const { return entity < m_actorSlots.size() ? m_actorSlots[entity].actor : nullptr; }
+    void SetGravity(const Vec3& gravity) { m_gravity = gravity; }
+    const Vec3& GetGravity() const { return m_gravity; }
+
 private:
-    // Component storage owned by the world
-    std::vector<std::unique_ptr<class DD_MeshComponent>> m_meshComponents;
-    std::vector<std::unique_ptr<class DD_CollisionComponent>> m_collisionComponents;
+    // Component pools owned by the world, keyed by DD_Actor::GetEntityId()
+    DD_ComponentPool<DD_MeshComponent> m_meshPool;
+    DD_ComponentPool<DD_CollisionComponent> m_collisionPool;
+    DD_ComponentPool<DD_RigidBodyComponent> m_bodyPool;
+    template<typename T> DD_ComponentPool<T>& GetPool();
     std::vector<DD_Material*> m_materials;
     std::vector<DD_Texture*> m_textures;
 
+    // Declared before the actors, which free their slots when destroyed
+    DD_TransformStorage m_transforms;
     std::vector<std::unique_ptr<class DD_Actor>> m_actors;
     std::vector<DD_LightActor*> m_lights;  // Non-owning pointers to lights in m_actors
+
+    // Actor table indexed by entity id; free slots are reused with a new generation
+    struct ActorSlot
+    {
+        DD_Actor* actor = nullptr;
+        uint32_t generation = 0;
+        uint32_t denseIndex = 0;  // Position in m_actors
+    };
+    std::vector<ActorSlot> m_actorSlots;
+    std::vector<uint32_t> m_freeActorSlots;
+
+    // Command buffers, one per thread that recorded into this world; never released
+    // before the world so threads can cache theirs
+    std::vector<std::unique_ptr<DD_CommandBuffer>> m_commandBuffers;
+    std::unordered_map<std::thread::id, DD_CommandBuffer*> m_commandBufferByThread;
+    std::mutex m_commandBufferMutex;
+    uint64_t m_worldSerial;  // Tells thread caches apart from those of a destroyed world
+    uint32_t m_appliedCommandCount = 0;
     DD_LightActor* m_mainLight;            // Primary light for shadows
 
     std::unique_ptr<class DD_Camera> m_camera;
@@ -68,26 +217,92 @@ private:
     int m_viewportHeight;
 
     float m_simTime = 0.0f;
+    bool m_parallelUpdate = true;
+    float m_interpolationAlpha = 1.0f;
+    DD_TransformHierarchy m_transformHierarchy;
+    TransformStats m_transformStats;
+    DD_RenderQueue m_renderQueue;
+    RenderStats m_renderStats;
+    // Bounds in mesh pool order, and one visibility bit per mesh instance for each pass
+    DD_FrustumCuller m_culler;
+    std::vector<uint64_t> m_passVisibility[static_cast<int>(RenderPass::Count)];
+    bool m_frustumCulling = true;
+
+    // Procedural oscillators, rotators and orbits, evaluated after the actor updates
+    DD_MoverSystem m_movers{ m_transforms };
 
-    // simple per-actor mover for cosine-based motion used in simulation
-    struct Mover
+    // Collision system
+    std::unique_ptr<DD_Broadphase> m_broadphase;
+    BroadphaseType m_broadphaseType;
+    float m_spatialHashCellSize;
+    std::vector<BroadphasePair> m_broadphasePairs;
+    DD_ColliderCache m_colliderCache;  // Indexed by proxy id
+    std::vector<CollisionContact> m_contacts;
+    DD_CollisionIslands m_islands;
+    std::vector<uint8_t> m_fixedProxies;  // Per proxy id, static or kinematic in m_contacts
+    CollisionStats m_collisionStats;
+
+    // Rigid body contact, solved with sequential impulses
+    struct BodyContact
+    {
+        int proxyA;
+        int proxyB;
+        DD_RigidBodyComponent* bodyA;  // nullptr for static colliders
+        DD_RigidBodyComponent* bodyB;
+        float invMassA;
+        float invMassB;
+        Vec3 normal;    // From A to B
+        float depth;
+        float bounce;   // Separating velocity target from restitution
+        float impulse;  // Accumulated normal impulse
+    };
+    // Last tick's impulse per proxy pair, used to warm start the solver
+    struct CachedImpulse
     {
-        bool enabled = false;
-        Vec3 basePosition;
-        float amplitude = 0.0f;
-        float frequency = 1.0f;
-        float phase = 0.0f;
-        Vec3 axis;
+        Vec3 normal;
+        float impulse;
+        bool touched;
     };
-    std::vector<Mover> m_movers;
+    Vec3 m_gravity;
+    std::vector<BodyContact> m_bodyContacts;
+    std::vector<CollisionContact> m_sleepLinks;  // Body contacts with static sides folded onto the body
+    std::unordered_map<uint64_t, CachedImpulse> m_impulseCache;
 
     // collision helpers
     void ProcessCollisions(float deltaTime);
+    void ProcessCollisionsBruteForce();
+    void SyncBroadphase();
+    void DestroyProxy(DD_CollisionComponent* col);
+    void DetectContacts();
+    void AddContact(int proxyA, int proxyB, const Vec3& mtv);
+    void ResolveContacts();
+    void CountLayerPair(const CollisionFilter& a, const CollisionFilter& b);
+    void IntegrateVelocities(float deltaTime);
+    void SolveBodyContacts();
+    void UpdateSleeping(float deltaTime);
+    void IntegratePositions(float deltaTime);
+    bool SweepFastBody(const DD_RigidBodyComponent* body, const Vec3& delta, float& outTOI, Vec3& outNormal);
+    bool ResolveCollision(class DD_Actor* actorA, class DD_Actor* actorB);
+    void ApplyContact(class DD_Actor* actorA, class DD_Actor* actorB, const Vec3& mtv);
+    template<typename Fn>
+    void VisitQueryCandidates(const std::vector<int>& proxies, Fn&& fn) const;
+
+    // Takes ownership, moves the actor's transform into m_transforms and registers it in
+    // the transform hierarchy
+    DD_Actor* AdoptActor(std::unique_ptr<class DD_Actor> actor);
+
+    // Rebuilds the world matrices of actors moved since the last frame, once, before any pass
+    void UpdateTransforms();
 
     // Rendering passes
     void RenderShadowPass();
     void RenderScenePass();
     void RenderDeferred();
     void RenderLegacy();  // Fallback without shadows
+    void BuildRenderQueue(bool shadowPass, bool litPass);
 };
 
+template<> inline DD_ComponentPool<DD_MeshComponent>& DD_World::GetPool<DD_MeshComponent>() { return m_meshPool; }
+template<> inline DD_ComponentPool<DD_CollisionComponent>& DD_World::GetPool<DD_CollisionComponent>() { return m_collisionPool; }
+template<> inline DD_ComponentPool<DD_RigidBodyComponent>& DD_World::GetPool<DD_RigidBodyComponent>() { return m_bodyPool; }
+